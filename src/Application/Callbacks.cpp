@@ -161,6 +161,13 @@ void GameObject::Callbacks::WindowMoveCallback(int x, int y) noexcept
 
 void GameObject::Callbacks::CloseCallback() noexcept { game.mainLoopActive = false; }
 
+void GameObject::Callbacks::RunQueuedEvents()
+{
+	// Applied in the order they happened, with the world mutex held
+	for (const std::function<void()> &event : m_queuedEvents) event();
+	m_queuedEvents.clear();
+}
+
 void GameObject::Callbacks::TakeScreenshot() noexcept
 {
 	bool error = false;
@@ -180,7 +187,7 @@ void GameObject::Callbacks::TakeScreenshot() noexcept
 		error = true;
 	}
 	
-	const auto ScreenshotEnd = [&](const std::string &finalText) {
+	const auto ScreenshotEnd = [this](const std::string &finalText) {
 		// Update chat with results
 		AddChatMessage(finalText);
 		// Temporarily show chat text
@@ -216,31 +223,36 @@ void GameObject::Callbacks::TakeScreenshot() noexcept
 	// Get full path of image to save to
 	const std::string directoryfmt = fmt::format("{}/{}", screenshotfolder, filenamefmt);
 
-	// Flip Y axis as OGL uses opposite Y coordinates (bottom-top instead of top-bottom)
-	std::vector<unsigned char> flippedPixels(3u * w * h);
-	for (int x = 0; x < w; ++x) {
-		for (int y = 0; y < h; ++y) {
-			for (int s = 0; s < 3; ++s) {
-				flippedPixels[(x + y * w) * 3 + s] = pixels[(x + (h - 1 - y) * w) * 3 + s];
+	// Encoding the image is slow, so it is done on another thread and the result is given back to the main thread
+	// (only one screenshot is encoded at a time)
+	if (m_screenshotThread.joinable()) m_screenshotThread.join();
+	m_screenshotThread = std::thread([=](const std::vector<unsigned char> &pixels) {
+		// Flip Y axis as OGL uses opposite Y coordinates (bottom-top instead of top-bottom)
+		std::vector<unsigned char> flippedPixels(3u * w * h);
+		for (int x = 0; x < w; ++x) {
+			for (int y = 0; y < h; ++y) {
+				for (int s = 0; s < 3; ++s) {
+					flippedPixels[(x + y * w) * 3 + s] = pixels[(x + (h - 1 - y) * w) * 3 + s];
+				}
 			}
 		}
-	}
-
-	// Save to PNG file in directory constructed above (RGB colours, no alpha)
-	const bool success = lodepng::encode(directoryfmt, flippedPixels, w, h, LodePNGColorType::LCT_RGB) == 0u;
 
-	// Clear both vectors to save memory usage
-	flippedPixels.clear();
-	pixels.clear();
+		// Save to PNG file in directory constructed above (RGB colours, no alpha)
+		const bool success = lodepng::encode(directoryfmt, flippedPixels, w, h, LodePNGColorType::LCT_RGB) == 0u;
 
-	// Create result text to be displayed
-	if (success) {
-		ScreenshotEnd("Screenshot saved as " + filenamefmt);
-		TextFormat::log("Screenshot taken");
-	}
-	else ScreenshotEnd(failedText);
+		// Display result text on the main thread
+		game.tasks.Post([=]() {
+			if (success) {
+				ScreenshotEnd("Screenshot saved as " + filenamefmt);
+				TextFormat::log("Screenshot taken");
+			}
+			else ScreenshotEnd(failedText);
+		});
+	}, std::move(pixels));
 }
 
+GameObject::Callbacks::~Callbacks() { if (m_screenshotThread.joinable()) m_screenshotThread.join(); }
+
 void GameObject::Callbacks::ToggleInventory() noexcept
 {
 	m_app->player.inventoryOpened = !m_app->player.inventoryOpened; // Determine if inventory elements should be rendered
@@ -352,7 +364,7 @@ void GameObject::Callbacks::ApplyInput(int key, int action) noexcept
 	// Debug inputs
 	{ GLFW_KEY_Z, pressInput, [&]() { glPolygonMode(GL_FRONT_AND_BACK, revBool(game.wireframe) ? GL_LINE : GL_FILL); }},
 	{ GLFW_KEY_R, pressInput, [&]() {
-		game.shaders.InitShaders();
+		game.shaders.InitShaders(true);
 		m_app->world.textRenderer.UpdateShaderUniform();
 		m_app->world.DebugChunkBorders(false);
 		TextFormat::log("Reloaded shaders");
@@ -536,14 +548,47 @@ void GameObject::Callbacks::ApplyCommand()
 		queryMult("camera direction is", glm::dvec2(plr.yaw, plr.pitch), 3);
 		noQueryConversion = true;
 	}},
-	{ "fill", "xFrom yFrom zFrom xTo yTo zTo block", "Fills from the 'from' position to the 'to' position with the specified block ID", [&]() {
+	{ "fill", "xFrom yFrom zFrom xTo yTo zTo block", "Fills from the 'from' position to the 'to' position (inclusive) with the specified block ID", [&]() {
+		CMDConv({ tcv(0, plrposInt.x), tcv(1, plrposInt.y), tcv(2, plrposInt.z), tcv(3, plrposInt.x), tcv(4, plrposInt.y), tcv(5, plrposInt.z) });
+		const auto IArg = [&](int i){ return IntArg<PosType>(i); };
+		EditBlocks({ { IArg(0), IArg(1), IArg(2) }, { IArg(3), IArg(4), IArg(5) }, IntArg<ObjectIDTypeof, ObjectID>(6) });
+	}},
+	{ "replace", "xFrom yFrom zFrom xTo yTo zTo from to", "Replaces all 'from' blocks between the two positions (inclusive) with 'to' blocks", [&]() {
 		CMDConv({ tcv(0, plrposInt.x), tcv(1, plrposInt.y), tcv(2, plrposInt.z), tcv(3, plrposInt.x), tcv(4, plrposInt.y), tcv(5, plrposInt.z) });
 		const auto IArg = [&](int i){ return IntArg<PosType>(i); };
-		const std::uintmax_t changed = world.FillBlocks({IArg(0), IArg(1), IArg(2)}, { IArg(3), IArg(4), IArg(5) }, IntArg<ObjectIDTypeof, ObjectID>(6));
-		if (changed) AddChatMessage(fmt::format("Too many blocks to change ({} > 32768). Try filling a smaller area.", changed));
+		World::BlockEdit edit = { { IArg(0), IArg(1), IArg(2) }, { IArg(3), IArg(4), IArg(5) }, IntArg<ObjectIDTypeof, ObjectID>(7) };
+		edit.replaceOnly = true;
+		edit.replaceBlock = IntArg<ObjectIDTypeof, ObjectID>(6);
+		EditBlocks(edit);
+	}},
+	{ "sphere", "x y z radius block", "Creates a sphere of the given block ID around a position", [&]() {
+		CMDConv({ tcv(0, plrposInt.x), tcv(1, plrposInt.y), tcv(2, plrposInt.z) });
+		const WorldPosition center = { IntArg<PosType>(0), IntArg<PosType>(1), IntArg<PosType>(2) };
+		const WorldPosition radius = WorldPosition(IntArg<PosType>(3, 0, 1000));
+		World::BlockEdit edit = { center - radius, center + radius, IntArg<ObjectIDTypeof, ObjectID>(4) };
+		edit.shape = World::BlockEdit::ES_Sphere;
+		EditBlocks(edit);
+	}},
+	{ "cylinder", "x y z radius height block", "Creates an upright cylinder of the given block ID starting at a position", [&]() {
+		CMDConv({ tcv(0, plrposInt.x), tcv(1, plrposInt.y), tcv(2, plrposInt.z) });
+		const WorldPosition base = { IntArg<PosType>(0), IntArg<PosType>(1), IntArg<PosType>(2) };
+		const PosType radius = IntArg<PosType>(3, 0, 1000), height = IntArg<PosType>(4, 1, ChunkValues::maxHeight);
+		World::BlockEdit edit = { base - WorldPosition(radius, 0, radius), base + WorldPosition(radius, height - 1, radius), IntArg<ObjectIDTypeof, ObjectID>(5) };
+		edit.shape = World::BlockEdit::ES_Cylinder;
+		EditBlocks(edit);
 	}},
 	{ "set", "x y z block", "Sets the given position to the given block.", [&]() {
-		world.SetBlock({ IntArg<PosType>(0), IntArg<PosType>(1), IntArg<PosType>(2) }, IntArg<ObjectIDTypeof, ObjectID>(3), true);
+		world.SetBlock({ IntArg<PosType>(0), IntArg<PosType>(1), IntArg<PosType>(2) }, IntArg<ObjectIDTypeof, ObjectID>(3));
+	}},
+	{ "undo", "*count", "Undoes the last block changes (each command or placed/broken block is one change)", [&]() { UndoEdits(HasArgument(0) ? IntArg<int>(0, 1, 1000) : 1, false); }},
+	{ "redo", "*count", "Changes blocks again after undoing", [&]() { UndoEdits(HasArgument(0) ? IntArg<int>(0, 1, 1000) : 1, true); }},
+	{ "journal", "megabytes", "Limits the memory used to keep block changes that can be undone (0 to disable)", [&]() {
+		world.journal.memoryLimit = IntArg<std::size_t>(0, 0u, 1024u) * static_cast<std::size_t>(1048576u);
+		if (!world.journal.memoryLimit) world.journal.Clear();
+	}, [&]() {
+		query("journal limit (MB)", world.journal.memoryLimit / static_cast<std::size_t>(1048576u));
+		if (queryChat) AddChatMessage(fmt::format("{} changes to undo, {} to redo ({} blocks, {:.1f} KB)", world.journal.UndoCount(), world.journal.RedoCount(),
+			fmt::group_digits(world.journal.BlocksCount()), static_cast<double>(world.journal.MemorySize()) / 1024.0));
 	}},
 	{ "dcmp", "id", "_Creates a new file on the same directory with the ASM code for a given shader program ID", [&]() {
 		std::vector<char> binary(65535);
@@ -558,6 +603,66 @@ void GameObject::Callbacks::ApplyCommand()
 		game.shaders.EachProgram([&](ShadersObject::Program &prog) { result += fmt::format("'{}': {}, ", prog.name, prog.program); });
 		AddChatMessage(result.substr(std::size_t{}, result.size() - static_cast<std::size_t>(2u)));
 	}},
+	{ "chunkgrid", "enabled", "_Looks up chunks in the grid around the player (1) or only in the chunk map (0)",
+		[&]() { world.useChunkGrid = IntArg<int>(0, 0, 1) != 0; }, [&]() { query("chunk grid state", static_cast<int>(world.useChunkGrid)); }
+	},
+	{ "blockshare", "enabled", "_Shares identical block data between new chunks (1) or not (0) - query shows the memory saved", 
+		[&]() { Chunk::blockPool.enabled = IntArg<int>(0, 0, 1) != 0; }, [&]() {
+		noQueryConversion = true;
+		if (!queryChat) return;
+
+		const BlockArrayPool::Stats stats = Chunk::blockPool.GetStats();
+		const std::string result = fmt::format("Block sharing {}: {} arrays used by {} chunks (ratio {:.2f}), {:.1f} MB saved at render distance {}",
+			Chunk::blockPool.enabled ? "enabled" : "disabled", fmt::group_digits(stats.arrays), fmt::group_digits(stats.references), 
+			stats.SharingRatio(), static_cast<double>(stats.BytesSaved()) / 1048576.0, world.chunkRenderDistance
+		);
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
+	{ "mapbench", "*distance", "_Times chunk map operations at render distances 16, 64 and 200 (or the given distance)", [&]() {
+		const std::vector<PosType> distances = HasArgument(0) ? std::vector<PosType>{ static_cast<PosType>(DblArg(0, 1.0, 500.0)) } : std::vector<PosType>{ 16, 64, 200 };
+		for (const PosType distance : distances) {
+			const std::string result = fmt::format("Distance {}: {}", distance, m_app->ChunkMapBenchmark(distance));
+			TextFormat::log(result);
+			AddChatMessage(result);
+		}
+	}},
+	{ "convbench", "", "_Times chunk offset conversions and block lookups around the player", [&]() {
+		const std::string result = m_app->CoordinateBenchmark();
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
+	{ "editbench", "*count", "_Times block changes around the player calculated per block and per frame (changes are undone)", [&]() {
+		const std::string result = m_app->EditBenchmark(HasArgument(0) ? IntArg<std::size_t>(0, 1u, 100000u) : static_cast<std::size_t>(1000u));
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
+	{ "snapshot", "*name", "_Keeps the loaded world and player state to restore later, optionally also writing it to a file with the given name", [&]() {
+		const std::string name = HasArgument(0) ? GetArg(0) : std::string();
+		if (name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-") != std::string::npos) throw std::invalid_argument("");
+		const std::string result = m_app->TakeWorldSnapshot(name);
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
+	{ "restore", "*name", "_Restores the world and player state from the last snapshot, or from the snapshot file with the given name", [&]() {
+		const std::string name = HasArgument(0) ? GetArg(0) : std::string();
+		if (name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-") != std::string::npos) throw std::invalid_argument("");
+		const std::string result = m_app->RestoreWorldSnapshot(name);
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
+	{ "mappedreads", "enabled", "_Loads saved columns from memory-mapped region files (1) or buffered reads (0)",
+		[&]() { world.regions.mappedReads = IntArg<int>(0, 0, 1) != 0; }, [&]() { query("mapped reads state", static_cast<int>(world.regions.mappedReads.load())); }
+	},
+	{ "regionbench", "", "_Times loading all saved columns in nearby region files with buffered and mapped reads (cold and warm)", [&]() {
+		const RegionStorage::ReadBenchmark bench = world.regions.BenchmarkReads();
+		const std::string result = fmt::format("Loaded {} columns from {} regions - buffered: {:.2f}ms cold, {:.2f}ms warm, mapped: {:.2f}ms cold, {:.2f}ms warm{}",
+			fmt::group_digits(bench.columns), bench.regions, bench.coldBufferedMs, bench.warmBufferedMs, bench.coldMappedMs, bench.warmMappedMs,
+			bench.evicted || !bench.regions ? "" : " (files could not be removed from the page cache)"
+		);
+		TextFormat::log(result);
+		AddChatMessage(result);
+	}},
 	{ "test", "*x *y *z *w", "_Sets 4 values for run-time testing", [&]() {
 		for (int i=0;i<4;++i) if (HasArgument(i)) game.testvals[i] = DblArg(i); 
 	}, [&]() { queryMult("debug values are", game.testvals); }},
@@ -573,9 +678,49 @@ void GameObject::Callbacks::ApplyCommand()
 	{ "tick", "", fmt::format("Changes the tick speed (how fast natural events occur) [{}, {}]", tickLimit.min, tickLimit.max),
 		[&]() { game.tickSpeed = DblArg(0, -100.0, 100.0); }, [&]() { query("tick", game.tickSpeed); }
 	},
+	{ "sim", "enabled *rate", "Runs player movement and chunk updates on a seperate thread (1) or the main thread (0), optionally setting the steps per second", [&]() {
+		game.simulationThread = IntArg<int>(0, 0, 1) != 0;
+		if (HasArgument(1)) game.simulationRate = DblArg(1, 1.0, 1000.0);
+	}, [&]() { query("simulation thread state", static_cast<int>(game.simulationThread)); }},
+	{ "budget", "", "Changes the time (in milliseconds) each frame can spend on deferred work such as buffer updates",
+		[&]() { game.frameBudgetMs = DblArg(0, 0.0, 1000.0); }, [&]() { query("frame budget", game.frameBudgetMs); }
+	},
 	{ "rd", "", fmt::format("Changes the world's render distance [{}, {}]", renderLimit.min, renderLimit.max),
 		[&]() { world.UpdateRenderDistance(IntArg<int>(0, renderLimit.min, renderLimit.max)); }, [&]() { query("render distance", m_app->world.chunkRenderDistance); }
 	},
+	{ "prefetch", "distance *margin", "Changes how many chunks are loaded ahead of you and optionally how many are kept loaded behind you", [&]() {
+		world.prefetchDistance = IntArg<int>(0, 0, renderLimit.max);
+		if (HasArgument(1)) world.unloadMargin = IntArg<int>(1, 0, renderLimit.max);
+		world.UpdateRenderDistance(world.chunkRenderDistance); // Resize buffers for the new number of loaded chunks
+	}, [&]() {
+		query("prefetch distance", world.prefetchDistance);
+		if (queryChat) AddChatMessage(fmt::format("Unload margin is {}, {:.1f}% of chunks were loaded in advance", world.unloadMargin, world.GetPrefetchHitRate()));
+	}},
+	{ "memorybudget", "megabytes *core", "Limits the memory used by chunks (0 for no limit) by evicting columns out of view, optionally changing how close columns are always kept", [&]() {
+		world.memoryBudget = IntArg<std::size_t>(0, 0u, 1048576u) * static_cast<std::size_t>(1048576u);
+		if (HasArgument(1)) world.coreRadius = IntArg<int>(1, 0, renderLimit.max);
+	}, [&]() {
+		query("memory budget (MB)", world.memoryBudget / static_cast<std::size_t>(1048576u));
+		if (queryChat) AddChatMessage(fmt::format("Core radius is {}, chunks use {:.1f} MB with {} columns evicted ({:.1f} MB)", world.coreRadius, 
+			static_cast<double>(world.residentBytes) / 1048576.0, world.EvictedColumns(), static_cast<double>(world.evictedBytes) / 1048576.0));
+	}},
+	{ "meshcache", "megabytes *disk", "Limits the memory used to keep faces of calculated chunks (0 to disable), optionally also keeping them in a file (1) or not (0)", [&]() {
+		world.meshCache.memoryLimit = IntArg<std::size_t>(0, 0u, 4096u) * static_cast<std::size_t>(1048576u);
+		if (!world.meshCache.memoryLimit) world.meshCache.Clear();
+		if (HasArgument(1)) world.meshCache.SetDiskPath(IntArg<int>(1, 0, 1) ? "Worlds/meshes.cache" : "");
+	}, [&]() {
+		query("mesh cache limit (MB)", world.meshCache.memoryLimit.load() / static_cast<std::size_t>(1048576u));
+		if (queryChat) AddChatMessage(fmt::format("{} meshes ({:.1f} MB, {:.1f} MB on disk) - {:.1f}% found ({} from disk, {} calculated)", fmt::group_digits(world.meshCache.Count()),
+			static_cast<double>(world.meshCache.MemorySize()) / 1048576.0, static_cast<double>(world.meshCache.DiskSize()) / 1048576.0, world.meshCache.HitRate(),
+			fmt::group_digits(world.meshCache.diskHits.load()), fmt::group_digits(world.meshCache.misses.load())));
+	}},
+	{ "coldchunks", "seconds", "Compresses the blocks of chunks that have been unused and out of view for the given time (0 to disable)",
+		[&]() { world.coldSeconds = DblArg(0, 0.0, 3600.0); }, [&]() {
+		query("cold chunk time", world.coldSeconds);
+		const Chunk::CompressionStats &stats = Chunk::compressionStats;
+		if (queryChat) AddChatMessage(fmt::format("{} chunks compressed ({:.1f}x, {:.1f} MB), {} decompressed - {:.1f}us average, {:.1f}us max", fmt::group_digits(stats.chunks),
+			stats.Ratio(), static_cast<double>(stats.bytes) / 1048576.0, fmt::group_digits(stats.decompressions), stats.AverageDecompressTime() * 1e6, stats.maxDecompressTime * 1e6));
+	}},
 	{ "fov", "", fmt::format("Sets the camera FOV. [{}, {}]", fovLimit.min, fovLimit.max),
 		[&]() { plr.fov = glm::radians(DblArg(0, fovLimit.min, fovLimit.max)); }, [&]() { query("FOV", glm::degrees(plr.fov)); }
 	},
@@ -668,6 +813,37 @@ void GameObject::Callbacks::ApplyCommand()
 }
 
 double GameObject::Callbacks::DblArg(int index, double min, double max) { return glm::clamp(std::stod(GetArg(index)), min, max); }
+void GameObject::Callbacks::EditBlocks(const World::BlockEdit &edit) noexcept
+{
+	const World::BlockEditResult result = m_app->world.EditBlocks(edit);
+	if (result.tooLarge) {
+		AddChatMessage(fmt::format("Too many blocks to change in unloaded chunks ({} > {}). Try a smaller area or move closer.", result.queued, static_cast<std::uintmax_t>(World::maxQueuedEdit)));
+		return;
+	}
+
+	std::string message = fmt::format("Changed {} blocks in {} chunks", result.changed, result.chunks);
+	if (result.queued) message += fmt::format(" ({} more in unloaded chunks)", result.queued);
+	AddChatMessage(message);
+}
+
+void GameObject::Callbacks::UndoEdits(int count, bool redo) noexcept
+{
+	World::BlockEditResult total{};
+	int applied = 0;
+	for (; applied < count; ++applied) {
+		if (!(redo ? m_app->world.journal.RedoCount() : m_app->world.journal.UndoCount())) break;
+		const World::BlockEditResult result = m_app->world.UndoEdit(redo);
+		total.changed += result.changed;
+		total.queued += result.queued;
+		total.chunks += result.chunks;
+	}
+
+	if (!applied) { AddChatMessage(redo ? "Nothing to redo" : "Nothing to undo"); return; }
+	std::string message = fmt::format("{} {} changes ({} blocks in {} chunks)", redo ? "Redid" : "Undid", applied, total.changed, total.chunks);
+	if (total.queued) message += fmt::format(" ({} more in unloaded chunks)", total.queued);
+	AddChatMessage(message);
+}
+
 void GameObject::Callbacks::CMDConv(const std::vector<ConversionData> &argsConversions) { for (const auto &val : argsConversions) CMDConv(val); }
 
 void GameObject::Callbacks::CMDConv(const ConversionData &data)
@@ -1,4 +1,5 @@
 #include "Definitions.hpp"
+#include "ResourcePack.hpp"
 
 // (Math namespace is all inline for now)
 
@@ -93,7 +94,7 @@ std::string OGL::GetString(GLenum stringID) noexcept { return reinterpret_cast<c
 
 // -------------------- ShadersObject -------------------- 
 
-void ShadersObject::InitShaders() { EachProgram([&](Program &prog) { InitProgram(prog); }); }
+void ShadersObject::InitShaders(bool reload) { EachProgram([&](Program &prog) { InitProgram(prog, reload); }); }
 void ShadersObject::EachProgram(std::function<void(Program&)> each)
 {
 	// Execute given function for each program
@@ -151,7 +152,7 @@ bool ShadersObject::CheckStatus(GLuint id, const std::string &name, bool isShade
 	return false; // False - there was an error
 }
 
-void ShadersObject::InitProgram(Program &prog)
+void ShadersObject::InitProgram(Program &prog, bool reload)
 {
 	// Create a new program (delete old one if it already exists - e.g. on reload)
 	if (prog.program) glDeleteProgram(prog.program);
@@ -161,11 +162,21 @@ void ShadersObject::InitProgram(Program &prog)
 		glDetachShader(prog.program, shader);
 		glDeleteShader(shader);
 	};
+
+	// Use the shader in the resource pack if it is open, otherwise read its file (files are used first when
+	// reloading so changed shaders can be seen, with the pack used for any that are not there)
+	const auto ReadShader = [reload](const std::string &name, std::string &contents) {
+		const std::string path = game.shadersFolder + name;
+		const bool useFile = reload && FileManager::FileExists(path);
+		const ResourcePack::Entry *packed = game.resourcePack && !useFile ? game.resourcePack->Find("Shaders/" + name) : nullptr;
+		if (packed) contents.assign(reinterpret_cast<const char*>(packed->data), packed->size);
+		else FileManager::ReadFile(path, contents, false, true);
+	};
 	
 	// Create a single compute shader alongside the program
 	if (prog.IsCompute()) {
 		std::string computeFile;
-		FileManager::ReadFile(game.computesFolder + prog.name, computeFile, false, true);
+		ReadShader("Compute/" + prog.name, computeFile);
 		prog.compute = CreateShader(computeFile, prog.name, GL_COMPUTE_SHADER);
 
 		glAttachShader(prog.program, prog.compute);
@@ -175,8 +186,8 @@ void ShadersObject::InitProgram(Program &prog)
 		std::string vertexFile, fragmentFile;
 		const std::string vertexName = prog.name + ".vert", fragmentName = prog.name + ".frag";
 
-		FileManager::ReadFile(game.shadersFolder + vertexName, vertexFile, false, true);
-		FileManager::ReadFile(game.shadersFolder + fragmentName, fragmentFile, false, true);
+		ReadShader(vertexName, vertexFile);
+		ReadShader(fragmentName, fragmentFile);
 		prog.vertex = CreateShader(vertexFile, vertexName, GL_VERTEX_SHADER);
 		prog.fragment = CreateShader(fragmentFile, fragmentName, GL_FRAGMENT_SHADER);
 
@@ -219,7 +230,7 @@ WorldNoise::WorldNoise(WorldPerlin::NoiseSpline *splines, std::int64_t *seeds)
 	WorldPerlin *perlins[] = { &elevation, &flatness, &depth, &temperature, &humidity };
 	for (int i = 0; i < NoiseEnums::MAX; ++i) {
 		WorldPerlin *perlin = perlins[i];
-		perlin->noiseSplines = splines[i];
+		if (splines) perlin->noiseSplines = splines[i];
 		perlin->ChangeSeed(seeds[i]);
 	}
 }
@@ -331,14 +342,23 @@ void FileManager::LoadImage(ImageInfo &info, const std::string &filename, const
 		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColours);
 	}
 
-	// Load in found image whilst setting data
-	if (lodepng::decode(
-		info.data, info.width, info.height,
-		game.texturesFolder + filename, formatInfo.imgFormat, formatInfo.bitDepth
-	)) throw FileManager::FileError("Image load fail");
+	// Use the decoded image in the resource pack if it has the same format (8-bit RGBA), otherwise decode the image file
+	const ResourcePack::Entry *packed = game.resourcePack ? game.resourcePack->Find("Textures/" + filename) : nullptr;
+	const unsigned char *pixels;
+	if (packed && packed->image && formatInfo.imgFormat == LodePNGColorType::LCT_RGBA && formatInfo.bitDepth == 8u) {
+		info.width = packed->width;
+		info.height = packed->height;
+		pixels = packed->data;
+	} else {
+		if (lodepng::decode(
+			info.data, info.width, info.height,
+			game.texturesFolder + filename, formatInfo.imgFormat, formatInfo.bitDepth
+		)) throw FileManager::FileError("Image load fail");
+		pixels = info.data.data();
+	}
 
 	// Save the texture data into the currently bound texture object
-	glTexImage2D(GL_TEXTURE_2D, 0, formatInfo.OGLFormat, info.width, info.height, 0, formatInfo.OGLFormat, GL_UNSIGNED_BYTE, info.data.data());
+	glTexImage2D(GL_TEXTURE_2D, 0, formatInfo.OGLFormat, info.width, info.height, 0, formatInfo.OGLFormat, GL_UNSIGNED_BYTE, pixels);
 
 	// Create mipmaps (with bias setting for different LODs) for the texture 
 	if (doMipMap) {
@@ -373,9 +393,67 @@ void GameGlobal::Init() noexcept
 	startTime = std::time(nullptr);
 }
 
+void GameGlobal::TaskQueue::Post(const TaskFunction &function, Priority priority, const void *key) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Replace the same queued task (in any priority) so it is only done once
+	if (key) for (std::deque<Task> &queue : m_tasks) for (Task &task : queue) {
+		if (task.key != key) continue;
+		task.function = function;
+		return;
+	}
+
+	m_tasks[priority].push_back({ function, key });
+}
+
+std::size_t GameGlobal::TaskQueue::Run(double budgetMs) noexcept
+{
+	const double startTime = glfwGetTime(), budget = budgetMs * 0.001;
+	std::size_t count{};
+
+	// At least one task is run each frame so work is never stalled by a small budget
+	do {
+		TaskFunction function;
+		{
+			// Get the next task with the highest priority - the lock is not held whilst it is 
+			// running as the task itself (or another thread) can post more tasks
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::deque<Task> *queue = std::find_if(m_tasks, m_tasks + TP_Count, [](const std::deque<Task> &q) { return !q.empty(); });
+			if (queue == m_tasks + TP_Count) break;
+			function = std::move(queue->front().function);
+			queue->pop_front();
+		}
+
+		function();
+		++count;
+	} while (glfwGetTime() - startTime < budget);
+
+	tasksRun += count;
+	if (glfwGetTime() - startTime > budget) ++framesOverBudget;
+	return count;
+}
+
+std::size_t GameGlobal::TaskQueue::Pending() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::size_t total{};
+	for (const std::deque<Task> &queue : m_tasks) total += queue.size();
+	return total;
+}
+
+void GameGlobal::TaskQueue::Clear() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (std::deque<Task> &queue : m_tasks) queue.clear();
+}
+
 void GameGlobal::Cleanup() noexcept
 {
+	game.tasks.Clear(); // Remove any tasks that were not run
 	game.shaders.DestroyAll(); // Delete created shaders
 	delete[] genThreads; // Delete world generation threads
+	delete resourcePack; // Close resource pack
+	resourcePack = nullptr;
 	glDeleteBuffers(static_cast<GLsizei>(sizeof(GameUBOs) / sizeof(GLuint)), reinterpret_cast<GLuint*>(&game.ubos)); // Delete all UBOs
 }
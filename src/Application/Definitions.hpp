@@ -35,6 +35,7 @@
 #include <thread>
 
 #include <ctime>
+#include <deque>
 #include <string>
 #include <cstring>
 #include <sstream>
@@ -65,6 +66,8 @@ namespace OGL
 	
 	std::string GetString(GLenum stringID) noexcept;
 };
+class ResourcePack;
+
 // Image information
 struct ImageInfo
 {
@@ -89,8 +92,13 @@ struct Math
 {
 	struct WPHash { 
 		std::size_t operator()(const WorldPosition &vec) const noexcept { 
-			constexpr PosType one = static_cast<PosType>(1);
-			return vec.x ^ ( ( (vec.y << one) ^ (vec.z << one) ) >> one);
+			// Multiply each axis by a different odd constant and mix so nearby positions spread across the whole range
+			// (power-of-two tables use the lowest bits directly)
+			std::uint64_t hash = static_cast<std::uint64_t>(vec.x) * 0x9E3779B97F4A7C15ull;
+			hash ^= static_cast<std::uint64_t>(vec.y) * 0xC2B2AE3D27D4EB4Full;
+			hash ^= static_cast<std::uint64_t>(vec.z) * 0x165667B19E3779F9ull;
+			hash ^= hash >> 32u; hash *= 0xD6E8FEB86659FD93ull; hash ^= hash >> 32u;
+			return static_cast<std::size_t>(hash);
 		}
 	};
 
@@ -182,9 +190,9 @@ struct ShadersObject
 		        border    = "Border";
 	} programs;
 	
-	void InitShaders();
+	void InitShaders(bool reload = false); // Reloading reads any shader files before the resource pack
 	void EachProgram(std::function<void(Program&)> each);
-	static void InitProgram(Program &prog);
+	static void InitProgram(Program &prog, bool reload = false);
 
 	static bool CheckStatus(GLuint id, const std::string &name, bool isShader) noexcept;
 	static GLuint CreateShader(const std::string& fileData, const std::string &name, GLenum type);
@@ -267,6 +275,7 @@ struct GameGlobal
 	bool debugText = true;
 	bool chunkBorders = false;
 	bool hideFog = false;
+	bool simulationThread = false; // Run player movement and chunk updates on a seperate thread
 	
 	double tickSpeed = 1.0;
 	double tickedDeltaTime = 0.016;
@@ -279,9 +288,13 @@ struct GameGlobal
 	
 	double mouseX = 0.0, mouseY = 0.0, sensitivity = 0.1;
 	double deltaTime = 0.016;
+	double frameBudgetMs = 4.0; // Time given to deferred tasks each frame
+	double simulationRate = 60.0; // Simulation steps per second when using the simulation thread
 	
 	std::string currentDirectory;
 	std::string texturesFolder, shadersFolder, computesFolder;
+	ResourcePack *resourcePack = nullptr; // Open until the game ends if it exists (shaders are also created after startup)
+	double resourcesLoadTime = 0.0; // Seconds taken to load textures and shaders at startup
 	
 	WorldNoise noiseGenerators;
 	
@@ -373,6 +386,27 @@ struct GameGlobal
 	PerfTest *perfPointers[sizeof(PerfObject) / sizeof(PerfTest)];
 	std::size_t perfPointersCount;
 
+	// Work that needs to be done on the main thread (e.g. OpenGL calls) but does not need to happen
+	// immediately - executed each frame in priority order until the frame budget is used up.
+	struct TaskQueue
+	{
+		enum Priority : std::uint8_t { TP_High, TP_Normal, TP_Low, TP_Count };
+		typedef std::function<void()> TaskFunction;
+
+		// Thread-safe. If a key is given and a task with the same key is already queued, 
+		// that task is replaced instead so repeated requests are only done once.
+		void Post(const TaskFunction &function, Priority priority = TP_Normal, const void *key = nullptr) noexcept;
+		std::size_t Run(double budgetMs) noexcept;
+		std::size_t Pending() noexcept;
+		void Clear() noexcept;
+
+		std::uintmax_t tasksRun{}, framesOverBudget{};
+	private:
+		struct Task { TaskFunction function; const void *key; };
+		std::deque<Task> m_tasks[TP_Count];
+		std::mutex m_mutex;
+	} tasks;
+
 	struct GameUBOs { GLuint matricesUBO, timesUBO, coloursUBO, positionsUBO, sizesUBO; } ubos;
 
 	void Cleanup() noexcept;
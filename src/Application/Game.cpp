@@ -1,4 +1,5 @@
 #include "Game.hpp"
+#include "ResourcePack.hpp"
 
 GameObject::GameObject() noexcept :
 	player(playerFunctions.player),	
@@ -87,10 +88,18 @@ void GameObject::InitGame(char *location)
 	
 	// Attempt to find resource folders - located in the same directory as exe
 	const std::string resourcesFolder = game.currentDirectory + "/Resources/";
-	if (!FileManager::DirectoryExists(resourcesFolder)) throw std::runtime_error("Resources folder not found");
 	game.shadersFolder = resourcesFolder + "Shaders/";
 	game.texturesFolder = resourcesFolder + "Textures/";
 	game.computesFolder = game.shadersFolder + "Compute/";
+
+	// Resources are used from the pack built with the game if it exists (the resource files are only needed without it)
+	const double resourcesStart = glfwGetTime();
+	game.resourcePack = new ResourcePack;
+	if (!game.resourcePack->Open(game.currentDirectory + "/Resources.pack")) {
+		delete game.resourcePack;
+		game.resourcePack = nullptr;
+		if (!FileManager::DirectoryExists(resourcesFolder)) throw std::runtime_error("Resources folder not found");
+	}
 	
 	// Load game textures with specific formats and save information about them
 	FileManager::LoadImage(game.blocksTextureInfo, "atlas.png");
@@ -113,6 +122,9 @@ void GameObject::InitGame(char *location)
 	OGL::UpdateUBO(game.ubos.sizesUBO, sizesData, sizeof(sizesData));
 
 	game.shaders.InitShaders(); // Initialize shader class
+	game.resourcesLoadTime = glfwGetTime() - resourcesStart;
+	TextFormat::log(fmt::format("Resources loaded from {} in {:.2f}ms", game.resourcePack ? "pack" : "files", game.resourcesLoadTime * 1000.0));
+
 	ChunkLookupData::CalculateLookupData(); // Calculate chunk terrain lookup data into global
 
 	TextFormat::log("Game init complete");
@@ -129,7 +141,18 @@ void GameObject::Main()
 	game.mainLoopActive = true;
 	
 	while (game.mainLoopActive) {
-		// Poll I/O such as key and mouse events
+		UpdateSimulationThread(); // Start or stop the simulation thread if the setting changed
+
+		// With a simulation thread, the world is only updated (loaded columns, changed chunks and queued tasks) when
+		// it is not in the middle of a simulation step. Otherwise events are queued until it is and the camera from
+		// the latest step is drawn, so the frame rate does not depend on the simulation.
+		const bool threaded = m_simulationRunning;
+		std::unique_lock<std::mutex> worldLock(m_worldMutex, std::defer_lock);
+		const bool canUpdate = !threaded || worldLock.try_lock();
+
+		// Poll I/O such as key and mouse events (after any queued from previous frames)
+		if (canUpdate) callbacks.RunQueuedEvents();
+		callbacks.queueEvents = !canUpdate;
 		glfwPollEvents();
 
 		// Time values
@@ -143,14 +166,29 @@ void GameObject::Main()
 		game.daySeconds += game.tickedDeltaTime;
 		if (game.daySeconds >= m_skybox.fullDaySeconds) { game.daySeconds = 0.0; ++game.worldDay; }
 
-		playerFunctions.CheckInput(); // Check for per-frame inputs
-		playerFunctions.ApplyMovement(); // Apply smoothed movement using velocity and other position-related functions
-		if (player.moved) MovedUpdate(); // Update matrices and frustum on position change
+		if (threaded) m_heldInput = playerFunctions.GetHeldInput(); // Inputs are applied in the next simulation step
+		if (canUpdate) {
+			if (!threaded) {
+				playerFunctions.CheckInput(playerFunctions.GetHeldInput(), game.deltaTime); // Check for per-frame inputs
+				playerFunctions.ApplyMovement(game.deltaTime); // Apply smoothed movement using velocity and other position-related functions
+			}
+
+			if (player.moved) MovedUpdate(); // Update matrices and frustum on position change
+			world.UpdateIO(); // Add columns loaded from region files
+			world.UpdateDirtyChunks(); // Calculate chunks changed since the last frame
+			game.tasks.Run(game.frameBudgetMs); // Run queued main thread tasks (buffer updates, text, etc) within the frame budget
+		}
+
+		// Player values used for rendering (from the latest simulation step if it is on another thread)
+		SimulationSnapshot camera;
+		if (threaded) camera = GetSnapshot();
+		else FillSnapshot(camera);
+		if (worldLock.owns_lock()) worldLock.unlock(); // Rendering only uses data owned by the main thread
 
-		UpdateFrameValues(); // Update shader UBO values (day/night cycle, sky colours)
+		UpdateFrameValues(camera); // Update shader UBO values (camera, day/night cycle, sky colours)
 
 		// Game rendering
-		playerFunctions.RenderBlockOutline();
+		playerFunctions.RenderBlockOutline(camera.targetBlock);
 		world.DrawWorld();
 		world.DebugChunkBorders(true);
 		m_skybox.RenderSkyboxElements();
@@ -168,8 +206,8 @@ void GameObject::Main()
 			m_lowFPS = static_cast<int>(1.0 / largestUpdateTime);
 			m_nowFPS = static_cast<int>(1.0 / game.deltaTime);
 
-			// Update or check things periodically
-			MiscUpdate();
+			// Update or check things periodically - text updates can wait if the frame is busy
+			game.tasks.Post([this]() { MiscUpdate(); }, GameGlobal::TaskQueue::TP_Low, &m_infoText);
 
 			// Reset values
 			largestUpdateTime = game.deltaTime;
@@ -179,12 +217,86 @@ void GameObject::Main()
 
 		// Swap the buffers so the game window updates with the new frame
 		glfwSwapBuffers(game.window);
+
+		// Startup time (from initializing GLFW) is logged after the first frame
+		if (!game.gameFrame++) TextFormat::log(fmt::format("First frame after {:.1f}ms", glfwGetTime() * 1000.0));
 	}
 
+	game.simulationThread = false;
+	UpdateSimulationThread(); // Stop simulation thread if it is running
 	TextFormat::log("Game exit");
 	glfwSetInputMode(game.window, GLFW_CURSOR, GLFW_CURSOR_NORMAL); // Free cursor in case it was
 }
 
+void GameObject::UpdateSimulationThread() noexcept
+{
+	// Called from the main loop when it is not holding the world mutex
+	if (game.simulationThread == m_simulationRunning) return;
+
+	if (game.simulationThread) {
+		FillSnapshot(m_snapshots[m_frontSnapshot]); // Drawn until the first step is done
+		m_simulationRunning = true;
+		m_simulationThread = std::thread(&GameObject::SimulationLoop, this);
+		TextFormat::log("Simulation thread started");
+	} else {
+		m_simulationRunning = false;
+		m_simulationThread.join();
+		m_heldInput = std::uint8_t{};
+		TextFormat::log("Simulation thread stopped");
+	}
+}
+
+void GameObject::SimulationLoop() noexcept
+{
+	// Player movement (and the chunk updates it causes) are done at a fixed rate on this thread 
+	// whilst the main thread renders and handles events. Any OpenGL work is posted to the main thread.
+	double nextStep = glfwGetTime();
+
+	while (m_simulationRunning) {
+		const double stepTime = 1.0 / glm::max(game.simulationRate, 1.0), stepStart = glfwGetTime();
+		{
+			std::lock_guard<std::mutex> lock(m_worldMutex);
+			playerFunctions.CheckInput(m_heldInput, stepTime);
+			playerFunctions.ApplyMovement(stepTime);
+			PublishSnapshot(glfwGetTime() - stepStart);
+		}
+
+		// Wait until the next step (don't try to catch up if behind)
+		nextStep += stepTime;
+		const double waitTime = nextStep - glfwGetTime();
+		if (waitTime > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(waitTime));
+		else nextStep = glfwGetTime();
+	}
+}
+
+void GameObject::PublishSnapshot(double stepTime) noexcept
+{
+	// Write into the back snapshot (not read by the main thread) then swap them
+	SimulationSnapshot &back = m_snapshots[m_frontSnapshot ^ 1];
+	FillSnapshot(back);
+	back.step = m_snapshots[m_frontSnapshot].step + 1u;
+	back.stepTime = stepTime;
+
+	std::lock_guard<std::mutex> lock(m_snapshotMutex);
+	m_frontSnapshot ^= 1;
+}
+
+void GameObject::FillSnapshot(SimulationSnapshot &snapshot) const noexcept
+{
+	// Camera matrices are calculated here as the camera direction is changed with the world mutex held
+	snapshot.position = player.position;
+	snapshot.targetBlockPosition = player.targetBlockPosition;
+	snapshot.targetBlock = player.targetBlock;
+	snapshot.zeroMatrix = playerFunctions.GetZeroMatrix();
+	snapshot.yZeroMatrix = playerFunctions.GetYZeroMatrix();
+}
+
+GameObject::SimulationSnapshot GameObject::GetSnapshot() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_snapshotMutex);
+	return m_snapshots[m_frontSnapshot];
+}
+
 void GameObject::MiscUpdate() noexcept
 {
 	// Check or update some things at a fixed rate, could be too expensive/unnecessary to do so every frame.
@@ -198,7 +310,7 @@ void GameObject::MiscUpdate() noexcept
 
 	// Update dynamic information text
 
-	static const std::string infoFmtText = "\n{} {} {}{}({} {} {})\nVelocity: {:.2f} {:.2f} {:.2f}\nYaw:{:.1f} Pitch:{:.1f} ({}, {})\nFOV:{:.1f} Speed:{:.1f}\nFlying: {} Noclip: {}";
+	static const std::string infoFmtText = "\n{} {} {}{}({} {} {})\nVelocity: {:.2f} {:.2f} {:.2f}\nYaw:{:.1f} Pitch:{:.1f} ({}, {})\nFOV:{:.1f} Speed:{:.1f}\nFlying: {} Noclip: {}\nSim. thread: {} Step: {:.2f}ms";
 	world.textRenderer.ChangeText(m_infoText, FPStext + fmt::format(infoFmtText,
 		TextFormat::groupDecimal(player.position.x), TextFormat::groupDecimal(player.position.y), TextFormat::groupDecimal(player.position.z),
 		isFarAway ? "\n" : " ",
@@ -206,18 +318,36 @@ void GameObject::MiscUpdate() noexcept
 		vel.x, vel.y, vel.z,
 		player.yaw, player.pitch,
 		game.constants.directionText[player.lookDirectionYaw], game.constants.directionText[player.lookDirectionPitch],
-		glm::degrees(player.fov), player.currentSpeed, !player.doGravity, player.noclip
+		glm::degrees(player.fov), player.currentSpeed, !player.doGravity, player.noclip,
+		m_simulationRunning.load(), GetSnapshot().stepTime * 1000.0
 	)); // Update first text info box
 	
 	// Determine if Y position for second info box needs to change due to large position/offset values
 	static bool wasFarAway = !isFarAway;
 	const bool isDifferent = isFarAway != wasFarAway;
 	if (isDifferent) world.textRenderer.ChangePosition(m_infoText2, { m_infoText2->GetPosition().x, world.textRenderer.GetRelativeTextYPos(m_infoText) }, false);
-	static const std::string infoFmt2Text = "Chunks: {} (Rendered: {})\nTriangles: {} (Rendered: {})\nRenderDist: {} Generating: {} Ind.Calls: {}\nTime: {:.1f} (Day {})";
+
+	// Region file I/O rate since the last update
+	const double ioTime = glfwGetTime();
+	const std::uintmax_t ioBytes = world.regions.BytesTransferred();
+	const double ioRate = ioTime > m_lastIOTime ? static_cast<double>(ioBytes - m_lastIOBytes) / (1024.0 * (ioTime - m_lastIOTime)) : 0.0;
+	m_lastIOTime = ioTime;
+	m_lastIOBytes = ioBytes;
+
+	const double meshesPerChunk = world.generatedChunksCount ? static_cast<double>(world.meshedChunksCount) / static_cast<double>(world.generatedChunksCount) : 0.0;
+	static const std::string infoFmt2Text = "Chunks: {} (Rendered: {}) Meshes/chunk: {:.2f}\nTriangles: {} (Rendered: {})\nRenderDist: {} Generating: {} Ind.Calls: {}\nPrefetch: {} Hits: {:.1f}%\nTasks: {} Over budget: {}\nQueued blocks: {} (Chunks: {})\nI/O queue: {} ({:.1f} KB/s)\nMemory: {:.1f} MB Evicted: {} ({:.1f} MB)\nCompressed: {} ({:.1f}x, {:.1f}us)\nMesh cache: {:.1f}% ({}, {:.1f} MB)\nUndo: {} Redo: {} ({:.1f} KB)\nTime: {:.1f} (Day {})";
 	world.textRenderer.ChangeText(m_infoText2, fmt::format(infoFmt2Text, 
-		fmt::group_digits(world.allchunks.size()), fmt::group_digits(world.renderChunksCount),
+		fmt::group_digits(world.allcolumns.size() * static_cast<std::size_t>(ChunkValues::heightCount)), fmt::group_digits(world.renderChunksCount), meshesPerChunk,
 		fmt::group_digits(world.squaresCount * 2u), fmt::group_digits(world.renderSquaresCount * 2u),
 		world.chunkRenderDistance, !game.noGeneration, fmt::group_digits(world.GetIndirectCalls()),
+		world.prefetchDistance, world.GetPrefetchHitRate(),
+		game.tasks.Pending(), fmt::group_digits(game.tasks.framesOverBudget),
+		fmt::group_digits(world.QueuedBlocksCount()), fmt::group_digits(world.QueueChunksCount()),
+		world.regions.QueueDepth(), ioRate,
+		static_cast<double>(world.residentBytes) / 1048576.0, fmt::group_digits(world.EvictedColumns()), static_cast<double>(world.evictedBytes) / 1048576.0,
+		fmt::group_digits(Chunk::compressionStats.chunks), Chunk::compressionStats.Ratio(), Chunk::compressionStats.AverageDecompressTime() * 1e6,
+		world.meshCache.HitRate(), fmt::group_digits(world.meshCache.Count()), static_cast<double>(world.meshCache.MemorySize()) / 1048576.0,
+		world.journal.UndoCount(), world.journal.RedoCount(), static_cast<double>(world.journal.MemorySize()) / 1024.0,
 		game.daySeconds, game.worldDay
 	)); // Update second text info box
 
@@ -272,34 +402,36 @@ void GameObject::UpdateAspect() noexcept
 
 void GameObject::MovedUpdate() noexcept
 {
-	// Calculate perspective and origin (no translation) matrices
+	// Calculate perspective matrix (the camera matrices are updated every frame)
 	m_perspectiveMatrix = glm::mat4(glm::perspective(
 		player.fov,
 		static_cast<double>(game.aspect),
 		player.frustum.nearPlaneDistance,
 		player.frustum.farPlaneDistance
 	)); 
-	glm::mat4 originMatrix = m_perspectiveMatrix * playerFunctions.GetZeroMatrix();
-	OGL::UpdateUBO(game.ubos.matricesUBO, &originMatrix, sizeof(glm::mat4)); // Set UBO matrix value
 
-	world.SortWorldBuffers(); // Sort the world buffers to determine what needs to be rendered
+	world.QueueBufferSort(); // Sort the world buffers to determine what needs to be rendered
 	player.moved = false; // Use to check for next matrix and world buffer update
 }
 
-void GameObject::UpdateFrameValues() noexcept
+void GameObject::UpdateFrameValues(const SimulationSnapshot &camera) noexcept
 {
 	game.perfs.frameCols.Start();
 
+	// Origin (no translation) matrix
+	const glm::mat4 originMatrix = m_perspectiveMatrix * camera.zeroMatrix;
+	OGL::UpdateUBO(game.ubos.matricesUBO, &originMatrix, sizeof(glm::mat4));
+
 	// Update positions UBO
 	const double gamePositions[] = {
 		// relativeRaycastBlockPosition
-		static_cast<double>(player.targetBlockPosition.x) - player.position.x,
-		static_cast<double>(player.targetBlockPosition.y) - player.position.y,
-		static_cast<double>(player.targetBlockPosition.z) - player.position.z, 0.0,
+		static_cast<double>(camera.targetBlockPosition.x) - camera.position.x,
+		static_cast<double>(camera.targetBlockPosition.y) - camera.position.y,
+		static_cast<double>(camera.targetBlockPosition.z) - camera.position.z, 0.0,
 		// playerPosition
-		player.position.x,
-		player.position.y,
-		player.position.z, 0.0
+		camera.position.x,
+		camera.position.y,
+		camera.position.z, 0.0
 	};
 	OGL::UpdateUBO(game.ubos.positionsUBO, gamePositions, sizeof(gamePositions));
 	
@@ -309,13 +441,13 @@ void GameObject::UpdateFrameValues() noexcept
 	const float dayProgress = 2.0f * static_cast<float>(glm::abs(timeOverFullDay - glm::floor(timeOverFullDay + 0.5))); // 0 = midday, 1 = midnight
 	
 	// Update star and sun/moon matrices
-	const glm::mat4 zeroMatrix = m_perspectiveMatrix * playerFunctions.GetZeroMatrix(); // 'Zero' matrix so skybox elements always appear around camera
+	const glm::mat4 &zeroMatrix = originMatrix; // 'Zero' matrix so skybox elements always appear around camera
 	const float rotationAmount = game.daySeconds / (m_skybox.fullDaySeconds / glm::two_pi<float>());
 
 	glm::mat4 newMats[] = {
 		glm::rotate(zeroMatrix, rotationAmount, glm::vec3(0.7f, 0.54f, 0.2f)), // starMatrix
 		glm::rotate(zeroMatrix, rotationAmount, glm::vec3(-1.0f, 0.0f, 0.0f)), // planetsMatrix
-		m_perspectiveMatrix * playerFunctions.GetYZeroMatrix()                 // skyMatrix
+		m_perspectiveMatrix * camera.yZeroMatrix                               // skyMatrix
 	};
 	OGL::UpdateUBO(game.ubos.matricesUBO, newMats, sizeof(newMats), sizeof(glm::mat4));
 
@@ -371,6 +503,274 @@ void GameObject::DebugFunctionTest() noexcept
 	fmt::print("*** {}s at {} loop(s) - {} funcs/s ***\n", functime, fmt::group_digits(times), TextFormat::groupDecimal(times / functime));
 }
 
+std::string GameObject::ChunkMapBenchmark(PosType renderDistance) const noexcept
+{
+	// Compare the chunk map against the previous standard map and position hash with the chunks
+	// that would be loaded at the given render distance (centered on the origin)
+	struct XorHash {
+		std::size_t operator()(const WorldPosition &vec) const noexcept {
+			constexpr PosType one = static_cast<PosType>(1);
+			return vec.x ^ (((vec.y << one) ^ (vec.z << one)) >> one);
+		}
+	};
+
+	std::vector<WorldPosition> offsets, lookups;
+	for (PosType x = -renderDistance; x <= renderDistance; ++x) {
+		const PosType zRange = renderDistance - glm::abs(x);
+		for (PosType z = -zRange; z <= zRange; ++z) {
+			for (PosType y{}; y < static_cast<PosType>(ChunkValues::heightCount); ++y) offsets.emplace_back(x, y, z);
+		}
+	}
+
+	// Lookups are nearby positions (about half of them are outside the loaded area or height)
+	std::uint32_t state = 12345u;
+	const PosType lookupRange = renderDistance * static_cast<PosType>(2) + static_cast<PosType>(1);
+	lookups.reserve(offsets.size());
+	for (std::size_t i{}; i < offsets.size(); ++i) {
+		state ^= state << 13u; state ^= state >> 17u; state ^= state << 5u;
+		lookups.emplace_back(
+			static_cast<PosType>(state % static_cast<std::uint32_t>(lookupRange)) - renderDistance,
+			static_cast<PosType>((state >> 8u) % static_cast<std::uint32_t>(ChunkValues::heightCount * 2)),
+			static_cast<PosType>((state >> 16u) % static_cast<std::uint32_t>(lookupRange)) - renderDistance
+		);
+	}
+
+	const double nanoseconds = 1e9 / static_cast<double>(offsets.size());
+	std::uintmax_t found{}; // Used so lookups are not optimized away
+	Chunk *value = nullptr;
+	double times[2][3]{};
+
+	{
+		FlatPositionMap<Chunk*> map;
+		double start = glfwGetTime();
+		for (const WorldPosition &offset : offsets) map.insert({ offset, value });
+		times[0][0] = (glfwGetTime() - start) * nanoseconds;
+		start = glfwGetTime();
+		for (const WorldPosition &offset : lookups) found += map.find(offset) != map.end();
+		times[0][1] = (glfwGetTime() - start) * nanoseconds;
+		start = glfwGetTime();
+		for (const WorldPosition &offset : offsets) map.erase(offset);
+		times[0][2] = (glfwGetTime() - start) * nanoseconds;
+	}
+	{
+		std::unordered_map<WorldPosition, Chunk*, XorHash> map;
+		double start = glfwGetTime();
+		for (const WorldPosition &offset : offsets) map.insert({ offset, value });
+		times[1][0] = (glfwGetTime() - start) * nanoseconds;
+		start = glfwGetTime();
+		for (const WorldPosition &offset : lookups) found += map.find(offset) != map.end();
+		times[1][1] = (glfwGetTime() - start) * nanoseconds;
+		start = glfwGetTime();
+		for (const WorldPosition &offset : offsets) map.erase(offset);
+		times[1][2] = (glfwGetTime() - start) * nanoseconds;
+	}
+
+	return fmt::format("Chunk map ({} chunks, {} found): insert {:.1f}ns, get {:.1f}ns, erase {:.1f}ns - previous map: insert {:.1f}ns, get {:.1f}ns, erase {:.1f}ns",
+		fmt::group_digits(offsets.size()), fmt::group_digits(found), 
+		times[0][0], times[0][1], times[0][2], times[1][0], times[1][1], times[1][2]
+	);
+}
+
+std::string GameObject::CoordinateBenchmark() const noexcept
+{
+	// Compare the previous chunk offset and local position conversions with the shift and mask
+	// versions, as well as single block lookups with batched ones, using positions around the player
+	const std::size_t count = static_cast<std::size_t>(1u << 20u);
+	WorldPosition *positions = new WorldPosition[count], *offsets = new WorldPosition[count];
+	glm::ivec3 *localPositions = new glm::ivec3[count];
+	ObjectID *blocks = new ObjectID[count];
+
+	std::uint32_t state = 12345u;
+	const WorldPosition center = ChunkValues::ToWorld(player.position);
+	for (std::size_t i{}; i < count; ++i) {
+		state ^= state << 13u; state ^= state >> 17u; state ^= state << 5u;
+		positions[i] = center + WorldPosition(
+			static_cast<PosType>(state & 127u) - static_cast<PosType>(64), 
+			static_cast<PosType>((state >> 8u) & 63u) - static_cast<PosType>(32),
+			static_cast<PosType>((state >> 16u) & 127u) - static_cast<PosType>(64)
+		);
+	}
+
+	// Previous conversions (branch, modulo and divide)
+	const auto PreviousOffset = [](PosType v) {
+		const PosType a = v < PosType{} ? v - static_cast<PosType>(ChunkValues::sizeLess) : v;
+		return (a - (a % static_cast<PosType>(ChunkValues::size))) / static_cast<PosType>(ChunkValues::size);
+	};
+	const auto PreviousLocal = [&](PosType v) { return static_cast<int>(v - (static_cast<PosType>(ChunkValues::size) * PreviousOffset(v))); };
+
+	const double nanoseconds = 1e9 / static_cast<double>(count);
+	double times[5]{};
+	std::uintmax_t checksum{}; // Used so results are not optimized away
+
+	double start = glfwGetTime();
+	for (std::size_t i{}; i < count; ++i) {
+		const WorldPosition &pos = positions[i];
+		offsets[i] = { PreviousOffset(pos.x), PreviousOffset(pos.y), PreviousOffset(pos.z) };
+		localPositions[i] = { PreviousLocal(pos.x), PreviousLocal(pos.y), PreviousLocal(pos.z) };
+	}
+	times[0] = (glfwGetTime() - start) * nanoseconds;
+	for (std::size_t i{}; i < count; ++i) checksum += static_cast<std::uintmax_t>(offsets[i].x + localPositions[i].z);
+
+	start = glfwGetTime();
+	for (std::size_t i{}; i < count; ++i) {
+		offsets[i] = ChunkValues::WorldToOffset(positions[i]);
+		localPositions[i] = ChunkValues::WorldToLocal(positions[i]);
+	}
+	times[1] = (glfwGetTime() - start) * nanoseconds;
+	for (std::size_t i{}; i < count; ++i) checksum += static_cast<std::uintmax_t>(offsets[i].x + localPositions[i].z);
+
+	start = glfwGetTime();
+	ChunkValues::WorldToOffsetLocal(positions, count, offsets, localPositions);
+	times[2] = (glfwGetTime() - start) * nanoseconds;
+	for (std::size_t i{}; i < count; ++i) checksum += static_cast<std::uintmax_t>(offsets[i].x + localPositions[i].z);
+
+	// Single lookups compared to a batch lookup
+	start = glfwGetTime();
+	for (std::size_t i{}; i < count; ++i) blocks[i] = world.GetBlock(positions[i]);
+	times[3] = (glfwGetTime() - start) * nanoseconds;
+	for (std::size_t i{}; i < count; ++i) checksum += static_cast<std::uintmax_t>(blocks[i]);
+
+	start = glfwGetTime();
+	world.GetBlocks(positions, blocks, count);
+	times[4] = (glfwGetTime() - start) * nanoseconds;
+	for (std::size_t i{}; i < count; ++i) checksum += static_cast<std::uintmax_t>(blocks[i]);
+
+	delete[] positions;
+	delete[] offsets;
+	delete[] localPositions;
+	delete[] blocks;
+
+	return fmt::format("Conversions ({} positions, checksum {}): previous {:.2f}ns, shift {:.2f}ns, batch {:.2f}ns - GetBlock {:.2f}ns, GetBlocks {:.2f}ns",
+		fmt::group_digits(count), checksum % 1000u, times[0], times[1], times[2], times[3], times[4]
+	);
+}
+
+std::string GameObject::EditBenchmark(std::size_t count) noexcept
+{
+	// Compare calculating chunks after every block change (as breaking and placing blocks used to) with
+	// changing all blocks first, using random positions around the player that are restored afterwards
+	WorldPosition *positions = new WorldPosition[count];
+	ObjectID *previousBlocks = new ObjectID[count], *newBlocks = new ObjectID[count];
+
+	std::uint32_t state = 12345u;
+	const WorldPosition center = ChunkValues::ToWorld(player.position);
+	for (std::size_t i{}; i < count; ++i) {
+		state ^= state << 13u; state ^= state >> 17u; state ^= state << 5u;
+		positions[i] = center + WorldPosition(
+			static_cast<PosType>(state & 63u) - static_cast<PosType>(32), 
+			static_cast<PosType>((state >> 8u) & 31u) - static_cast<PosType>(16),
+			static_cast<PosType>((state >> 16u) & 63u) - static_cast<PosType>(32)
+		);
+		positions[i].y = glm::clamp(positions[i].y, PosType{}, static_cast<PosType>(ChunkValues::maxHeight - 1));
+		newBlocks[i] = ObjectID::Planks;
+	}
+	world.GetBlocks(positions, previousBlocks, count);
+
+	// Benchmark edits are not recorded so they do not replace the actions that can be undone, and are not saved as
+	// every block is restored afterwards (positions in unloaded chunks are skipped)
+	const std::size_t journalLimit = world.journal.memoryLimit;
+	world.journal.memoryLimit = std::size_t{};
+	world.saveEdits = false;
+
+	const std::uintmax_t meshedBefore = world.meshedChunksCount;
+	double start = glfwGetTime();
+	for (std::size_t i{}; i < count; ++i) {
+		world.SetBlock(positions[i], newBlocks[i]);
+		world.UpdateDirtyChunks();
+	}
+	const double singleTime = (glfwGetTime() - start) * 1000.0;
+	const std::uintmax_t singleChunks = world.meshedChunksCount - meshedBefore;
+
+	world.SetBlocks(positions, previousBlocks, count);
+	world.UpdateDirtyChunks();
+
+	const std::uintmax_t meshedBatch = world.meshedChunksCount;
+	start = glfwGetTime();
+	world.SetBlocks(positions, newBlocks, count);
+	world.UpdateDirtyChunks();
+	const double batchTime = (glfwGetTime() - start) * 1000.0;
+	const std::uintmax_t batchChunks = world.meshedChunksCount - meshedBatch;
+
+	world.SetBlocks(positions, previousBlocks, count);
+	world.UpdateDirtyChunks();
+	world.journal.memoryLimit = journalLimit;
+	world.saveEdits = true;
+
+	delete[] positions;
+	delete[] previousBlocks;
+	delete[] newBlocks;
+
+	return fmt::format("Edits ({}): per block {:.2f}ms ({} chunk calculations), per frame {:.2f}ms ({} chunk calculations)",
+		fmt::group_digits(count), singleTime, fmt::group_digits(singleChunks), batchTime, fmt::group_digits(batchChunks)
+	);
+}
+
+std::string GameObject::SnapshotPath(const std::string &name) const noexcept
+{
+	return fmt::format("{}/Snapshots/{}.snapshot", world.directory, name);
+}
+
+std::string GameObject::TakeWorldSnapshot(const std::string &name) noexcept
+{
+	// The snapshot is kept in memory to restore quickly, and optionally also written to a file
+	const double start = glfwGetTime();
+	world.TakeSnapshot(m_worldSnapshot);
+
+	m_worldSnapshot.seed = game.noiseGenerators.elevation.seed;
+	m_worldSnapshot.position = player.position;
+	m_worldSnapshot.velocity = playerFunctions.GetVelocity();
+	m_worldSnapshot.yaw = player.yaw;
+	m_worldSnapshot.pitch = player.pitch;
+	for (int i = 0; i < 36; ++i) m_worldSnapshot.inventory[i] = { player.inventory[i].objectID, player.inventory[i].count };
+	m_worldSnapshot.noclip = player.noclip;
+	m_worldSnapshot.doGravity = player.doGravity;
+	m_worldSnapshot.daySeconds = game.daySeconds;
+	m_worldSnapshot.worldDay = game.worldDay;
+
+	const std::string result = fmt::format("Snapshot of {} columns taken in {:.2f}ms", fmt::group_digits(m_worldSnapshot.columns.size()), (glfwGetTime() - start) * 1000.0);
+	if (name.empty()) return result;
+
+	const std::string path = SnapshotPath(name);
+	const double writeStart = glfwGetTime();
+	if (!m_worldSnapshot.Write(path)) return fmt::format("{}, could not be written to '{}'", result, path);
+	return fmt::format("{}, written to '{}' in {:.2f}ms", result, path, (glfwGetTime() - writeStart) * 1000.0);
+}
+
+std::string GameObject::RestoreWorldSnapshot(const std::string &name) noexcept
+{
+	const double start = glfwGetTime();
+	// A snapshot file is checked before it replaces the one taken in this game
+	if (!name.empty()) {
+		WorldSnapshot read;
+		if (!read.Read(SnapshotPath(name))) return fmt::format("Snapshot '{}' could not be read", SnapshotPath(name));
+		if (read.seed != game.noiseGenerators.elevation.seed) return fmt::format("Snapshot is from a different world (seed {})", read.seed);
+		m_worldSnapshot.Swap(read);
+	}
+	const double readTime = (glfwGetTime() - start) * 1000.0;
+
+	if (m_worldSnapshot.IsEmpty()) return "No snapshot has been taken";
+	if (m_worldSnapshot.seed != game.noiseGenerators.elevation.seed) return fmt::format("Snapshot is from a different world (seed {})", m_worldSnapshot.seed);
+
+	const double restoreStart = glfwGetTime();
+	player.yaw = m_worldSnapshot.yaw;
+	player.pitch = m_worldSnapshot.pitch;
+	world.RestoreSnapshot(m_worldSnapshot);
+
+	playerFunctions.SetPosition(m_worldSnapshot.position);
+	playerFunctions.SetVelocity(m_worldSnapshot.velocity);
+	playerFunctions.UpdateCameraDirection();
+	player.noclip = m_worldSnapshot.noclip;
+	player.doGravity = m_worldSnapshot.doGravity;
+	for (int i = 0; i < 36; ++i) playerFunctions.UpdateSlot(i, m_worldSnapshot.inventory[i].objectID, m_worldSnapshot.inventory[i].count);
+
+	game.daySeconds = m_worldSnapshot.daySeconds;
+	game.worldDay = m_worldSnapshot.worldDay;
+
+	std::string result = fmt::format("Restored {} columns in {:.2f}ms", fmt::group_digits(m_worldSnapshot.columns.size()), (glfwGetTime() - restoreStart) * 1000.0);
+	if (!name.empty()) result += fmt::format(" (read in {:.2f}ms)", readTime);
+	return result;
+}
+
 void GameObject::PerlinResultTest() const noexcept
 {
 	// Test perlin noise results by creating an image
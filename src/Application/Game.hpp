@@ -4,6 +4,7 @@
 
 #include "Player/Player.hpp"
 #include "World/Sky.hpp"
+#include <atomic>
 
 class GameObject
 {
@@ -11,6 +12,7 @@ public:
 	struct Callbacks
 	{
 		Callbacks(GameObject *appPtr);
+		~Callbacks();
 	
 		void KeyPressCallback(int key, int scancode, int action, int mods);
 		void MouseClickCallback(int button, int action, int) noexcept;
@@ -29,6 +31,13 @@ public:
 		void BeginChat() noexcept;
 		void AddCommandText(std::string newText) noexcept;
 		void ApplyCommand();
+		void EditBlocks(const World::BlockEdit &edit) noexcept;
+		void UndoEdits(int count, bool redo) noexcept;
+
+		// Events change the world, so they are queued whilst the simulation thread is updating it
+		template<typename Event> void Dispatch(const Event &event) { if (queueEvents) m_queuedEvents.emplace_back(event); else event(); }
+		void RunQueuedEvents();
+		bool queueEvents = false;
 	private:
 		struct ConversionData {
 			ConversionData(int i, bool b, const std::string &s) noexcept : index(i), decimal(b), strarg(s) {}
@@ -40,6 +49,8 @@ public:
 		bool revBool(bool &b) const noexcept { b = !b; return b; }
 
 		GameObject *m_app = nullptr;
+		std::thread m_screenshotThread;
+		std::vector<std::function<void()>> m_queuedEvents;
 		std::vector<std::string> m_previousChats;
 		int m_chatHistorySelector = -1;
 
@@ -92,17 +103,52 @@ public:
 	void UpdateAspect() noexcept;
 private:
 	void DebugFunctionTest() noexcept;
+	std::string ChunkMapBenchmark(PosType renderDistance) const noexcept;
+	std::string CoordinateBenchmark() const noexcept;
+	std::string EditBenchmark(std::size_t count) noexcept;
+
+	std::string SnapshotPath(const std::string &name) const noexcept;
+	std::string TakeWorldSnapshot(const std::string &name) noexcept;
+	std::string RestoreWorldSnapshot(const std::string &name) noexcept;
 	void PerlinResultTest() const noexcept;
 
-	void UpdateFrameValues() noexcept;
 	void MovedUpdate() noexcept;
 	void MiscUpdate() noexcept;
+
+	// State of the world published by the simulation thread for rendering (also filled from the player every
+	// frame without the thread)
+	struct SimulationSnapshot {
+		glm::dvec3 position{};
+		WorldPosition targetBlockPosition{};
+		glm::mat4 zeroMatrix{ 1.0f }, yZeroMatrix{ 1.0f }; // Camera direction without the perspective
+		ObjectID targetBlock = ObjectID::Air;
+		std::uintmax_t step{};
+		double stepTime = 0.0;
+	};
+
+	void UpdateFrameValues(const SimulationSnapshot &camera) noexcept;
+	void UpdateSimulationThread() noexcept;
+	void SimulationLoop() noexcept;
+	void PublishSnapshot(double stepTime) noexcept;
+	void FillSnapshot(SimulationSnapshot &snapshot) const noexcept;
+	SimulationSnapshot GetSnapshot() noexcept;
+
+	std::thread m_simulationThread;
+	std::atomic<bool> m_simulationRunning{ false };
+	std::atomic<std::uint8_t> m_heldInput{};
+	std::mutex m_worldMutex, m_snapshotMutex; // World mutex is held whilst updating the world or player
+	SimulationSnapshot m_snapshots[2];
+	int m_frontSnapshot = 0;
+
+	WorldSnapshot m_worldSnapshot; // Taken and restored with commands
 	
 	glm::mat4 m_perspectiveMatrix;
 	
 	Skybox m_skybox;
 	
 	double m_lastTime = 0.0, m_updateTime = 0.0;
+	double m_lastIOTime = 0.0;
+	std::uintmax_t m_lastIOBytes{};
 	int m_nowFPS, m_avgFPS, m_lowFPS;
 	
 	TextRenderer::ScreenText *m_infoText, *m_infoText2, *m_chatText, *m_commandText, *m_perfText;
@@ -0,0 +1,62 @@
+#include "ResourcePack.hpp"
+
+bool ResourcePack::Open(const std::string &path) noexcept
+{
+	Close();
+	if (!FileManager::FileExists(path) || !m_file.Open(path, true)) return false;
+
+	const std::uint8_t *data = m_file.Data();
+	const std::size_t size = m_file.Size();
+	std::size_t position = ResourcePackFormat::headerSize;
+	const auto Read = [&](void *value, std::size_t bytes) {
+		if (size - position < bytes) return false;
+		std::memcpy(value, data + position, bytes);
+		position += bytes;
+		return true;
+	};
+
+	std::uint32_t version{}, count{};
+	if (size < ResourcePackFormat::headerSize || std::memcmp(data, ResourcePackFormat::magic, sizeof(ResourcePackFormat::magic))) { Close(); return false; }
+	std::memcpy(&version, data + sizeof(ResourcePackFormat::magic), sizeof(version));
+	std::memcpy(&count, data + sizeof(ResourcePackFormat::magic) + sizeof(version), sizeof(count));
+	if (version != ResourcePackFormat::version) {
+		TextFormat::warn(fmt::format("Resource pack '{}' has version {} (expected {})", path, version, ResourcePackFormat::version), "Resource pack error");
+		Close();
+		return false;
+	}
+
+	// Entry data is only checked to be inside the file - it is used directly from the mapped file
+	for (std::uint32_t i{}; i < count; ++i) {
+		std::uint16_t nameLength{};
+		std::uint8_t kind{};
+		std::uint32_t width{}, height{};
+		std::uint64_t offset{}, dataSize{};
+		if (!Read(&nameLength, sizeof(nameLength)) || size - position < nameLength) { m_entries.clear(); break; }
+		const std::string name(reinterpret_cast<const char*>(data + position), nameLength);
+		position += nameLength;
+
+		const bool valid = Read(&kind, sizeof(kind)) && Read(&width, sizeof(width)) && Read(&height, sizeof(height)) && Read(&offset, sizeof(offset)) && Read(&dataSize, sizeof(dataSize)) &&
+			offset <= size && dataSize <= size - offset && (kind != ResourcePackFormat::EK_Image || dataSize == static_cast<std::uint64_t>(width) * height * 4u);
+		if (!valid) { m_entries.clear(); break; }
+
+		const Entry entry = { data + offset, static_cast<std::size_t>(dataSize), width, height, kind == ResourcePackFormat::EK_Image };
+		m_entries[name] = entry;
+	}
+
+	if (IsOpen()) return true;
+	TextFormat::warn(fmt::format("Resource pack '{}' is invalid", path), "Resource pack error");
+	Close();
+	return false;
+}
+
+void ResourcePack::Close() noexcept
+{
+	m_entries.clear();
+	m_file.Close();
+}
+
+const ResourcePack::Entry *ResourcePack::Find(const std::string &name) const noexcept
+{
+	const auto found = m_entries.find(name);
+	return found == m_entries.end() ? nullptr : &found->second;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef _SOURCE_APPLICATION_RESOURCEPACK_HDR_
+#define _SOURCE_APPLICATION_RESOURCEPACK_HDR_
+
+#include "World/MappedFile.hpp"
+#include "ResourcePackFormat.hpp"
+
+// Shaders and decoded textures bundled into one file when building (by the packer tool), memory-mapped at startup so
+// resources are used directly from the file without reading each one or decoding any PNGs.
+class ResourcePack
+{
+public:
+	struct Entry {
+		const std::uint8_t *data;
+		std::size_t size;
+		std::uint32_t width, height; // Images only
+		bool image;
+	};
+
+	ResourcePack() noexcept {}
+	ResourcePack(const ResourcePack&) = delete;
+	ResourcePack &operator=(const ResourcePack&) = delete;
+
+	bool Open(const std::string &path) noexcept; // False if the pack does not exist or is invalid
+	void Close() noexcept;
+	bool IsOpen() const noexcept { return !m_entries.empty(); }
+
+	// Name is the path relative to the resources folder (e.g. "Shaders/Blocks.vert"), nullptr if not in the pack
+	const Entry *Find(const std::string &name) const noexcept;
+private:
+	MappedFile m_file;
+	std::unordered_map<std::string, Entry> m_entries;
+};
+
+#endif // _SOURCE_APPLICATION_RESOURCEPACK_HDR_
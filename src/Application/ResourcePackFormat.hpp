@@ -0,0 +1,25 @@
+#pragma once
+#ifndef _SOURCE_APPLICATION_RESOURCEPACKFORMAT_HDR_
+#define _SOURCE_APPLICATION_RESOURCEPACKFORMAT_HDR_
+
+#include <cstdint>
+#include <cstddef>
+
+// Layout of the resource pack, shared by the game and the packer tool (built separately without the game's libraries).
+// Header: magic, version and entry count, followed by each entry: name length (2 bytes), name (path relative to the
+// resources folder with '/' separators), kind (1 byte), width and height (4 bytes each, images only), data offset and
+// size (8 bytes each). Entry data follows the entries, with each one starting at a multiple of the alignment.
+namespace ResourcePackFormat
+{
+	const char magic[4] = { 'B', 'C', 'R', 'P' };
+	const std::uint32_t version = 1u;
+	const std::size_t headerSize = sizeof(magic) + (sizeof(std::uint32_t) * 2u);
+	const std::size_t dataAlignment = 16u;
+
+	enum Kind : std::uint8_t {
+		EK_File, // Contents of the file as-is (e.g. shaders)
+		EK_Image // PNG decoded to 8-bit RGBA pixels
+	};
+}
+
+#endif // _SOURCE_APPLICATION_RESOURCEPACKFORMAT_HDR_
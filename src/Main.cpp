@@ -53,13 +53,14 @@ static void GLErrorCallback(int err, const char *description)
 
 // OpenGL I/O callbacks can only be set as global functions -
 // use wrappers for the actual functions defined in the 'Callbacks' struct
+// (events that change the game are queued whilst the simulation thread is using the world)
 GameObject::Callbacks *callbacks;
-static void CharCallback(GLFWwindow*, unsigned codepoint) { callbacks->CharCallback(codepoint); }
-static void ResizeCallback(GLFWwindow*, int width, int height) { callbacks->ResizeCallback(width, height); }
-static void KeyPressCallback(GLFWwindow*, int key, int scancode, int action, int mods) { callbacks->KeyPressCallback(key, scancode, action, mods); }
-static void MouseClickCallback(GLFWwindow*, int button, int action, int mods) { callbacks->MouseClickCallback(button, action, mods); }
-static void ScrollCallback(GLFWwindow*, double xoffset, double yoffset) { callbacks->ScrollCallback(xoffset, yoffset); }
-static void MouseMoveCallback(GLFWwindow*, double xpos, double ypos) { callbacks->MouseMoveCallback(xpos, ypos); }
+static void CharCallback(GLFWwindow*, unsigned codepoint) { callbacks->Dispatch([=]() { callbacks->CharCallback(codepoint); }); }
+static void ResizeCallback(GLFWwindow*, int width, int height) { callbacks->Dispatch([=]() { callbacks->ResizeCallback(width, height); }); }
+static void KeyPressCallback(GLFWwindow*, int key, int scancode, int action, int mods) { callbacks->Dispatch([=]() { callbacks->KeyPressCallback(key, scancode, action, mods); }); }
+static void MouseClickCallback(GLFWwindow*, int button, int action, int mods) { callbacks->Dispatch([=]() { callbacks->MouseClickCallback(button, action, mods); }); }
+static void ScrollCallback(GLFWwindow*, double xoffset, double yoffset) { callbacks->Dispatch([=]() { callbacks->ScrollCallback(xoffset, yoffset); }); }
+static void MouseMoveCallback(GLFWwindow*, double xpos, double ypos) { callbacks->Dispatch([=]() { callbacks->MouseMoveCallback(xpos, ypos); }); }
 static void WindowMoveCallback(GLFWwindow*, int x, int y) { callbacks->WindowMoveCallback(x, y); }
 static void CloseCallback(GLFWwindow*) { callbacks->CloseCallback(); }
 
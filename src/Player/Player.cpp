@@ -157,51 +157,64 @@ void Player::RaycastDebugCheck() noexcept
 	glEnable(GL_CULL_FACE);
 }
 
-void Player::CheckInput() noexcept 
+std::uint8_t Player::GetHeldInput() const noexcept
 {
-	// Check for any input that requires holding
-	
-	// Get key state
+	// Get the state of any input that requires holding (GLFW key states can only be checked on the main thread)
 	const auto CheckKey = [](int key) {
 		return glfwGetKey(game.window, key) == GLFW_PRESS;
 	};
 
 	// Only check if there is a key being pressed and if the player isn't chatting or in inventory
-	if (game.anyKeyPressed && !game.chatting && !player.inventoryOpened) {
-		// Movement inputs
-		if (CheckKey(GLFW_KEY_W)) AddVelocity(PlayerDirection::Forwards);
-		if (CheckKey(GLFW_KEY_S)) AddVelocity(PlayerDirection::Backwards);
-		if (CheckKey(GLFW_KEY_A)) AddVelocity(PlayerDirection::Left);
-		if (CheckKey(GLFW_KEY_D)) AddVelocity(PlayerDirection::Right);
-
-		bool alreadyControl = false;
-		if (player.doGravity) {
-			// Jumping movement
-			if (CheckKey(GLFW_KEY_SPACE)) AddVelocity(PlayerDirection::Jump);
-		} else {
-			// Flying mode inputs
-			if (CheckKey(GLFW_KEY_SPACE)) AddVelocity(PlayerDirection::Fly_Up);
-			if (CheckKey(GLFW_KEY_LEFT_CONTROL)) { AddVelocity(PlayerDirection::Fly_Down); alreadyControl = true; }
-		}
+	std::uint8_t heldInput{};
+	if (!game.anyKeyPressed || game.chatting || player.inventoryOpened) return heldInput;
+
+	const struct { int key; HeldInput input; } inputKeys[] = {
+		{ GLFW_KEY_W, HI_Forwards }, { GLFW_KEY_S, HI_Backwards }, { GLFW_KEY_A, HI_Left }, { GLFW_KEY_D, HI_Right },
+		{ GLFW_KEY_SPACE, HI_Space }, { GLFW_KEY_LEFT_CONTROL, HI_Control }, { GLFW_KEY_LEFT_SHIFT, HI_Shift }
+	};
+	for (const auto &inputKey : inputKeys) if (CheckKey(inputKey.key)) heldInput |= inputKey.input;
+	return heldInput;
+}
+
+void Player::CheckInput(std::uint8_t heldInput, double deltaTime) noexcept 
+{
+	// Check for any input that requires holding
+	if (!heldInput) return;
+	const auto Held = [&](HeldInput input) { return (heldInput & input) != 0; };
+
+	// Movement inputs
+	if (Held(HI_Forwards)) AddVelocity(PlayerDirection::Forwards, deltaTime);
+	if (Held(HI_Backwards)) AddVelocity(PlayerDirection::Backwards, deltaTime);
+	if (Held(HI_Left)) AddVelocity(PlayerDirection::Left, deltaTime);
+	if (Held(HI_Right)) AddVelocity(PlayerDirection::Right, deltaTime);
 
-		// Speed modifiers
-		if (CheckKey(GLFW_KEY_LEFT_SHIFT)) player.currentSpeed = player.defaultSpeed * 1.5f;
-		else if (!alreadyControl && CheckKey(GLFW_KEY_LEFT_CONTROL)) player.currentSpeed = player.defaultSpeed * 0.5f;
-		else player.currentSpeed = player.defaultSpeed;
+	bool alreadyControl = false;
+	if (player.doGravity) {
+		// Jumping movement
+		if (Held(HI_Space)) AddVelocity(PlayerDirection::Jump, deltaTime);
+	} else {
+		// Flying mode inputs
+		if (Held(HI_Space)) AddVelocity(PlayerDirection::Fly_Up, deltaTime);
+		if (Held(HI_Control)) { AddVelocity(PlayerDirection::Fly_Down, deltaTime); alreadyControl = true; }
 	}
+
+	// Speed modifiers
+	if (Held(HI_Shift)) player.currentSpeed = player.defaultSpeed * 1.5f;
+	else if (!alreadyControl && Held(HI_Control)) player.currentSpeed = player.defaultSpeed * 0.5f;
+	else player.currentSpeed = player.defaultSpeed;
 }
 
-void Player::ApplyMovement() noexcept
+void Player::ApplyMovement(double deltaTime) noexcept
 {
 	game.perfs.movement.Start();
 
 	// Make player slowly come to a stop instead of immediately stopping when no movement is applied
 	// TODO: Framerate-independent lerp/smoothing
-	const double movementLerp = glm::clamp(game.deltaTime * 10.0, 0.0, 1.0);
+	const double movementLerp = glm::clamp(deltaTime * 10.0, 0.0, 1.0);
 	
 	// Apply gravity if enabled
 	const double gravity = -1.0, terminalVel = -10.0;
-	if (player.doGravity) m_velocity.y = glm::max(m_velocity.y + gravity * game.deltaTime, terminalVel);
+	if (player.doGravity) m_velocity.y = glm::max(m_velocity.y + gravity * deltaTime, terminalVel);
 	else m_velocity.y = Math::lerp(m_velocity.y, 0.0, movementLerp);
 
 	if (Math::largestUnsignedAxis(m_velocity) < 0.005) return; // Treat near-zero max velocity the same as no movement
@@ -250,12 +263,22 @@ void Player::ApplyMovement() noexcept
 		return false;
 	};
 	
+	constexpr std::size_t checksCount = Math::size(collisionChecks);
 	const auto CheckDirections = [&](const glm::dvec3 &newPos, double yPos, bool resetY, bool doGrounded) {
-		bool first = true;
-		for (const CollisionCheck &col : collisionChecks) {
-			if (!resetY && first) { first = false; continue; } // The 'Y only' check only applies to ground and ceiling checks
-			collidedBlockPos = ChunkValues::ToWorld(newPos + glm::dvec3(col.x, yPos, col.z)); // World position of block to check
-			if (!ChunkValues::GetBlockData(world->GetBlock(collidedBlockPos)).isSolid) continue; // Check for a solid block
+		// Get all of the blocks to check at once (nearby positions are usually in the same chunk)
+		WorldPosition checkPositions[checksCount];
+		ObjectID checkBlocks[checksCount];
+		for (std::size_t i{}; i < checksCount; ++i) {
+			const CollisionCheck &col = collisionChecks[i];
+			checkPositions[i] = ChunkValues::ToWorld(newPos + glm::dvec3(col.x, yPos, col.z)); // World position of block to check
+		}
+		world->GetBlocks(checkPositions, checkBlocks, checksCount);
+
+		// The 'Y only' check only applies to ground and ceiling checks
+		for (std::size_t i = resetY ? std::size_t{} : static_cast<std::size_t>(1u); i < checksCount; ++i) {
+			const CollisionCheck &col = collisionChecks[i];
+			collidedBlockPos = checkPositions[i];
+			if (!ChunkValues::GetBlockData(checkBlocks[i]).isSolid) continue; // Check for a solid block
 
 			// Reset Y velocity and possibly change grounded state for floor and ceiling checks
 			if (resetY) {
@@ -306,6 +329,11 @@ const glm::dvec3 &Player::GetVelocity() const noexcept
 	return m_velocity;
 }
 
+void Player::SetVelocity(const glm::dvec3 &newVelocity) noexcept
+{
+	m_velocity = newVelocity;
+}
+
 void Player::PositionVariables() noexcept
 {
 	player.moved = true;
@@ -325,7 +353,7 @@ void Player::BreakBlock() noexcept
 	// Check if the selected block is solid/valid
 	if (ChunkValues::GetBlockData(player.targetBlock).isSolid) {
 		// Set broken block to air and redo raycast
-		world->SetBlock(player.targetBlockPosition, ObjectID::Air, true);
+		world->SetBlock(player.targetBlockPosition, ObjectID::Air);
 		const int slotIndex = SearchForFreeMatchingSlot(player.targetBlock);
 		if (slotIndex != -1) UpdateSlot(slotIndex, player.targetBlock, player.inventory[slotIndex].count + 1u);
 		RaycastBlock();
@@ -347,15 +375,15 @@ void Player::PlaceBlock() noexcept
 		const WorldPosition playerLegsBlockPos = { playerBlockPos.x, playerBlockPos.y - static_cast<PosType>(1), playerBlockPos.z };
 		if (placePosition == playerBlockPos || placePosition == playerLegsBlockPos) return; // Don't place blocks inside the player
 
-		world->SetBlock(placePosition, placeBlock, true); // Place block on side of selected block
+		world->SetBlock(placePosition, placeBlock); // Place block on side of selected block
 		UpdateSlot(selected, placeBlock, useSlot.count - 1); // Update inventory slot with new count
 		RaycastBlock(); // Raycast again to update selection
 	}
 }
 
-void Player::AddVelocity(PlayerDirection direction) noexcept
+void Player::AddVelocity(PlayerDirection direction, double deltaTime) noexcept
 {
-	const double directionMultiplier = player.currentSpeed * game.deltaTime;
+	const double directionMultiplier = player.currentSpeed * deltaTime;
 
 	// Add to velocity based on frame time and input
 	switch (direction) {
@@ -416,10 +444,10 @@ int Player::SearchForFreeMatchingSlot(ObjectID item) noexcept
 	return -1;
 }
 
-void Player::RenderBlockOutline() const noexcept
+void Player::RenderBlockOutline(ObjectID targetBlock) const noexcept
 {
 	// Only show outline when the player is looking at a breakable block (e.g. can't break water or air)
-	if (!ChunkValues::GetBlockData(player.targetBlock).isSolid) return;
+	if (!ChunkValues::GetBlockData(targetBlock).isSolid) return;
 
 	// Enable outline program and bind VAO to use correct buffers
 	game.shaders.programs.outline.Use();
@@ -577,7 +605,10 @@ void Player::RaycastBlock() noexcept
 	placeBlockRelPosition = static_cast<glm::i8vec3>(previousTargetLocation - player.targetBlockPosition);
 
 	// Update block text if it's a different block than the previous (differs by position or type)
-	if (player.targetBlock != initialSelectedBlock || player.targetBlockPosition != initialSelectedPosition) UpdateBlockInfoText();
+	// (done on the main thread as this can be called from the simulation thread)
+	if (player.targetBlock != initialSelectedBlock || player.targetBlockPosition != initialSelectedPosition) {
+		game.tasks.Post([this]() { UpdateBlockInfoText(); }, GameGlobal::TaskQueue::TP_Normal, m_blockText);
+	}
 }
 
 void Player::UpdateBlockInfoText() noexcept
@@ -615,11 +646,13 @@ void Player::UpdateOffset() noexcept
 
 	// Check if offset changed
 	if ((initial.x != player.offset.x || initial.z != player.offset.z)) { 
-		world->DebugChunkBorders(false); // DEBUG - update chunk borders
+		player.velocity = m_velocity; // Used by the world to determine which chunks to load in advance
 		if (!game.noGeneration) world->OffsetUpdate(); // Update chunks (generation, deletion, etc)
 	}
-	// Also update debug chunk borders to match player Y chunk offset
-	else if (initial.y != player.offset.y) world->DebugChunkBorders(false);
+
+	// DEBUG - update chunk borders to match player chunk offset (on the main thread)
+	static const char bordersKey{};
+	if (initial != player.offset) game.tasks.Post([this]() { world->DebugChunkBorders(false); }, GameGlobal::TaskQueue::TP_Normal, &bordersKey);
 }
 
 void Player::UpdateFrustum() noexcept
@@ -34,27 +34,30 @@ public:
 	World *world;
 
 	enum class PlayerDirection : int { Forwards, Backwards, Left, Right, Fly_Up, Fly_Down, Jump };
+	enum HeldInput : std::uint8_t { HI_Forwards = 1, HI_Backwards = 2, HI_Left = 4, HI_Right = 8, HI_Space = 16, HI_Control = 32, HI_Shift = 64 };
 
 	Player() noexcept;
 	void WorldInitialize() noexcept;
-	void CheckInput() noexcept;
+	std::uint8_t GetHeldInput() const noexcept;
+	void CheckInput(std::uint8_t heldInput, double deltaTime) noexcept;
 	
 	void RaycastDebugCheck() noexcept;
 
-	void ApplyMovement() noexcept;
+	void ApplyMovement(double deltaTime) noexcept;
 	void SetPosition(const glm::dvec3 &newPos) noexcept;
 	const glm::dvec3 &GetVelocity() const noexcept;
+	void SetVelocity(const glm::dvec3 &newVelocity) noexcept;
 
 	void BreakBlock() noexcept;
 	void PlaceBlock() noexcept;
 
 	void UpdateCameraDirection(double x = 0.0, double y = 0.0) noexcept;
-	void AddVelocity(PlayerDirection move) noexcept;
+	void AddVelocity(PlayerDirection move, double deltaTime) noexcept;
 
 	int SearchForItem(ObjectID item, bool includeFull) noexcept;
 	int SearchForFreeMatchingSlot(ObjectID item) noexcept;
 
-	void RenderBlockOutline() const noexcept;
+	void RenderBlockOutline(ObjectID targetBlock) const noexcept;
 	void RenderPlayerGUI() const noexcept;
 	
 	glm::mat4 GetZeroMatrix() const noexcept;
@@ -29,6 +29,7 @@ struct WorldPlayer
 	ObjectID feetBlock = ObjectID::Air;
 
 	glm::dvec3 position{};
+	glm::dvec3 velocity{};
 
 	//double posMagnitude;
 	WorldPosition offset{};
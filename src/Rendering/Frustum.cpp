@@ -35,3 +35,20 @@ bool CameraFrustum::SphereInFrustum(const glm::dvec3 &center, double radius) con
 	       right .NDistToPlane(center) <= radius &&
 	       bottom.NDistToPlane(center) <= radius;
 }
+
+// Box culling check
+
+bool CameraFrustum::BoxInFrustum(const glm::dvec3 &minCorner, const glm::dvec3 &maxCorner) const noexcept
+{
+	// The box is outside if the corner furthest along a plane's normal is still outside of that plane
+	const auto InsidePlane = [&](const FrustumPlane &plane) {
+		const glm::dvec3 furthest = {
+			plane.normal.x > 0.0 ? maxCorner.x : minCorner.x,
+			plane.normal.y > 0.0 ? maxCorner.y : minCorner.y,
+			plane.normal.z > 0.0 ? maxCorner.z : minCorner.z
+		};
+		return plane.NDistToPlane(furthest) <= 0.0f;
+	};
+
+	return InsidePlane(top) && InsidePlane(near) && InsidePlane(left) && InsidePlane(right) && InsidePlane(bottom);
+}
@@ -23,6 +23,7 @@ struct CameraFrustum
 	void UpdateFrustum(const glm::dvec3 &position, const glm::dvec3 &cFront, const glm::dvec3 &cUp, const glm::dvec3 &cRight, double fov) noexcept;
 
 	bool SphereInFrustum(const glm::dvec3 &center, double radius) const noexcept;
+	bool BoxInFrustum(const glm::dvec3 &minCorner, const glm::dvec3 &maxCorner) const noexcept;
 
 	// The 'far' plane would prevent rendering of chunks further away than it so
 	// it is not included in frustum checks. This also improves performance slightly.
@@ -0,0 +1,61 @@
+// Tests the chunk map with random inserts, lookups and erases (including erasing whilst iterating and
+// growing the table) against a standard map. Run by CTest with the number of seconds to test for.
+// Usage: ChunkMapTest <seconds>
+
+#include "World/ChunkMap.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+namespace
+{
+	WorldPosition RandomPosition(std::uint32_t &state) noexcept
+	{
+		// Positions are in a 64x8x64 area
+		const PosType area = static_cast<PosType>(64);
+		state ^= state << 13u; state ^= state >> 17u; state ^= state << 5u;
+		return WorldPosition(static_cast<PosType>(state % area), static_cast<PosType>((state >> 8u) % 8u), static_cast<PosType>((state >> 16u) % area));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const double seconds = argc > 1 ? glm::clamp(std::atof(argv[1]), 0.1, 60.0) : 2.0;
+
+	FlatPositionMap<std::uint32_t> map;
+	std::unordered_map<WorldPosition, std::uint32_t, Math::WPHash> expected;
+	std::uint32_t state = 12345u;
+	std::uintmax_t inserts{}, erases{}, lookups{}, errors{};
+
+	const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	const auto Elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count(); };
+	while (Elapsed() < seconds) {
+		// Randomly insert or erase, checking lookups against the standard map
+		for (int w = 0; w < 1024; ++w) {
+			const WorldPosition position = RandomPosition(state);
+			const auto it = map.find(position);
+			const auto found = expected.find(position);
+			++lookups;
+			if ((it == map.end()) != (found == expected.end()) || (found != expected.end() && it->second != found->second)) ++errors;
+			if (it == map.end()) { map.insert({ position, state }); expected[position] = state; ++inserts; }
+			else { map.erase(it); expected.erase(position); ++erases; }
+		}
+
+		// Erase about a quarter of the entries whilst iterating, then check everything is still found
+		std::size_t visited{};
+		for (auto it = map.begin(); it != map.end(); ++visited) {
+			if (it->second & 3u) { ++it; continue; }
+			expected.erase(it->first);
+			it = map.erase(it);
+			++erases;
+		}
+		if (map.size() != expected.size()) ++errors;
+		for (const auto &it : expected) if (map.Get(it.first, it.second + 1u) != it.second) ++errors;
+		if (visited < map.size()) ++errors;
+	}
+
+	fmt::print("Chunk map test: {} lookups, {} inserts, {} erases, {} errors in {:.2f}s\n",
+		fmt::group_digits(lookups), fmt::group_digits(inserts), fmt::group_digits(erases), errors, Elapsed()
+	);
+	return errors || !inserts || !erases ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+// Bundles game resources into a single pack file when building, with PNG images decoded in advance.
+// Usage: ResourcePacker <resources folder> <output pack> <files relative to the resources folder...>
+
+#include "lodepng/lodepng.h"
+#include "Application/ResourcePackFormat.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct PackedEntry {
+		std::string name;
+		ResourcePackFormat::Kind kind;
+		unsigned width, height;
+		std::vector<unsigned char> data;
+	};
+
+	template<typename T> void Put(std::vector<unsigned char> &data, T value)
+	{
+		const std::size_t start = data.size();
+		data.resize(start + sizeof(T));
+		std::memcpy(data.data() + start, &value, sizeof(T));
+	}
+
+	bool EndsWith(const std::string &text, const char *end)
+	{
+		const std::size_t length = std::strlen(end);
+		return text.size() >= length && !text.compare(text.size() - length, length, end);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: %s <resources folder> <output pack> <files...>\n", argv[0]);
+		return 1;
+	}
+
+	const std::string folder = std::string(argv[1]) + "/", outputPath = argv[2];
+	std::vector<PackedEntry> entries;
+
+	for (int i = 3; i < argc; ++i) {
+		PackedEntry entry = { argv[i], ResourcePackFormat::EK_File, 0u, 0u, {} };
+		for (char &c : entry.name) if (c == '\\') c = '/';
+		if (entry.name.size() > 0xFFFFu) { std::fprintf(stderr, "Resource name too long: %s\n", argv[i]); return 1; }
+
+		// Images are decoded with the default format used by the game (8-bit RGBA)
+		const std::string path = folder + entry.name;
+		if (EndsWith(entry.name, ".png")) {
+			entry.kind = ResourcePackFormat::EK_Image;
+			const unsigned error = lodepng::decode(entry.data, entry.width, entry.height, path, LCT_RGBA, 8u);
+			if (error) { std::fprintf(stderr, "Failed to decode %s: %s\n", path.c_str(), lodepng_error_text(error)); return 1; }
+		} else {
+			std::ifstream file(path, std::ios::binary);
+			if (!file.good()) { std::fprintf(stderr, "Failed to read %s\n", path.c_str()); return 1; }
+			entry.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+		entries.emplace_back(std::move(entry));
+	}
+
+	// Entries need to be written first to know where the data starts
+	std::vector<unsigned char> pack(ResourcePackFormat::magic, ResourcePackFormat::magic + sizeof(ResourcePackFormat::magic));
+	Put(pack, ResourcePackFormat::version);
+	Put(pack, static_cast<std::uint32_t>(entries.size()));
+
+	std::size_t dataStart = pack.size();
+	for (const PackedEntry &entry : entries) dataStart += sizeof(std::uint16_t) + entry.name.size() + sizeof(std::uint8_t) + (sizeof(std::uint32_t) * 2u) + (sizeof(std::uint64_t) * 2u);
+
+	const std::size_t align = ResourcePackFormat::dataAlignment;
+	std::size_t offset = dataStart;
+	for (const PackedEntry &entry : entries) {
+		offset = (offset + align - 1u) / align * align;
+		Put(pack, static_cast<std::uint16_t>(entry.name.size()));
+		pack.insert(pack.end(), entry.name.begin(), entry.name.end());
+		Put(pack, static_cast<std::uint8_t>(entry.kind));
+		Put(pack, static_cast<std::uint32_t>(entry.width));
+		Put(pack, static_cast<std::uint32_t>(entry.height));
+		Put(pack, static_cast<std::uint64_t>(offset));
+		Put(pack, static_cast<std::uint64_t>(entry.data.size()));
+		offset += entry.data.size();
+	}
+
+	for (const PackedEntry &entry : entries) {
+		pack.resize((pack.size() + align - 1u) / align * align);
+		pack.insert(pack.end(), entry.data.begin(), entry.data.end());
+	}
+
+	// Write to a separate file first so a failed build does not leave a partly written pack
+	const std::string tempPath = outputPath + ".tmp";
+	std::FILE *file = std::fopen(tempPath.c_str(), "wb");
+	if (!file) { std::fprintf(stderr, "Failed to create %s\n", tempPath.c_str()); return 1; }
+	const bool written = std::fwrite(pack.data(), std::size_t{ 1u }, pack.size(), file) == pack.size();
+	if (std::fclose(file) || !written) { std::fprintf(stderr, "Failed to write %s\n", tempPath.c_str()); return 1; }
+
+	std::remove(outputPath.c_str()); // Renaming does not replace existing files on Windows
+	if (std::rename(tempPath.c_str(), outputPath.c_str())) { std::fprintf(stderr, "Failed to create %s\n", outputPath.c_str()); return 1; }
+
+	std::printf("Packed %u resources into %s (%u KB)\n", static_cast<unsigned>(entries.size()), outputPath.c_str(), static_cast<unsigned>(pack.size() / 1024u));
+	return 0;
+}
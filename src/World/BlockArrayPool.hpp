@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _SOURCE_WORLD_BLOCKARRAYPOOL_HDR_
+#define _SOURCE_WORLD_BLOCKARRAYPOOL_HDR_
+
+#include "Generation/Settings.hpp"
+
+// Shares identical chunk block arrays (e.g. fully underground or ocean chunks) between chunks. Arrays are found by
+// a hash of their contents and reference counted, and a chunk needs its own copy before changing any blocks.
+// Generation threads add arrays whilst the world thread changes and removes them, so everything is locked.
+class BlockArrayPool
+{
+public:
+	struct Stats {
+		std::size_t arrays, references; // Stored arrays and chunks using them
+		double SharingRatio() const noexcept { return arrays ? static_cast<double>(references) / static_cast<double>(arrays) : 0.0; }
+		std::size_t BytesSaved() const noexcept { return (references - arrays) * sizeof(ChunkValues::BlockArray); }
+	};
+
+	BlockArrayPool() noexcept {}
+	BlockArrayPool(const BlockArrayPool&) = delete;
+	BlockArrayPool &operator=(const BlockArrayPool&) = delete;
+
+	// Returns an existing array with the same blocks (deleting the given one) or adds the given array
+	ChunkValues::BlockArray *Share(ChunkValues::BlockArray *blocks) {
+		const std::uint64_t hash = Hash(*blocks);
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const auto range = m_hashes.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (std::memcmp(it->second->blocks, blocks->blocks, sizeof(ChunkValues::BlockArray))) continue; // Hash collision
+			++m_entries[it->second].references;
+			delete blocks;
+			return it->second;
+		}
+
+		m_entries[blocks] = { hash, static_cast<std::size_t>(1u) };
+		m_hashes.emplace(hash, blocks);
+		return blocks;
+	}
+
+	// Returns an array that can be changed - the same array if no other chunks use it (no longer shared), otherwise a copy
+	ChunkValues::BlockArray *Unshare(ChunkValues::BlockArray *blocks) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto found = m_entries.find(blocks);
+		if (found->second.references > static_cast<std::size_t>(1u)) {
+			--found->second.references;
+			ChunkValues::BlockArray *copy = new ChunkValues::BlockArray;
+			std::memcpy(copy->blocks, blocks->blocks, sizeof(ChunkValues::BlockArray));
+			return copy;
+		}
+		Remove(found);
+		return blocks;
+	}
+
+	// Stop using a shared array (deleted once no chunks use it)
+	void Release(ChunkValues::BlockArray *blocks) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto found = m_entries.find(blocks);
+		if (--found->second.references) return;
+		Remove(found);
+		delete blocks;
+	}
+
+	// Use an array that is already in the pool again (e.g. by a snapshot)
+	ChunkValues::BlockArray *Reference(ChunkValues::BlockArray *blocks) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_entries[blocks].references;
+		return blocks;
+	}
+
+	// Whether only one chunk uses the array
+	bool IsUnique(const ChunkValues::BlockArray *blocks) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_entries.find(blocks)->second.references == static_cast<std::size_t>(1u);
+	}
+
+	Stats GetStats() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Stats stats = { m_entries.size(), std::size_t{} };
+		for (const auto &it : m_entries) stats.references += it.second.references;
+		return stats;
+	}
+
+	bool enabled = true; // Only affects newly generated chunks
+private:
+	struct Entry {
+		std::uint64_t hash;
+		std::size_t references;
+	};
+	typedef std::unordered_map<const ChunkValues::BlockArray*, Entry> EntryMap;
+
+	void Remove(EntryMap::iterator entry) noexcept {
+		const auto range = m_hashes.equal_range(entry->second.hash);
+		for (auto it = range.first; it != range.second; ++it) if (it->second == entry->first) { m_hashes.erase(it); break; }
+		m_entries.erase(entry);
+	}
+
+	static_assert(!(sizeof(ChunkValues::BlockArray) % sizeof(std::uint64_t)), "Block arrays are hashed 8 bytes at a time.");
+	static std::uint64_t Hash(const ChunkValues::BlockArray &blocks) noexcept {
+		// Mix the blocks 8 at a time
+		const unsigned char *bytes = reinterpret_cast<const unsigned char*>(blocks.blocks);
+		std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+		for (std::size_t i{}; i < sizeof(ChunkValues::BlockArray); i += sizeof(std::uint64_t)) {
+			std::uint64_t word;
+			std::memcpy(&word, bytes + i, sizeof(std::uint64_t));
+			hash = (hash ^ word) * 0xC2B2AE3D27D4EB4Full;
+			hash ^= hash >> 29u;
+		}
+		return hash;
+	}
+
+	EntryMap m_entries;
+	std::unordered_multimap<std::uint64_t, ChunkValues::BlockArray*> m_hashes;
+	std::mutex m_mutex;
+};
+
+#endif // _SOURCE_WORLD_BLOCKARRAYPOOL_HDR_
@@ -1,9 +1,114 @@
 #include "Chunk.hpp"
 
-void Chunk::ConstructChunk(const WorldPerlin::NoiseResult *perlinResults, BlockQueueMap &blockQueue, WorldPosition offset) noexcept 
+BlockArrayPool Chunk::blockPool;
+Chunk::CompressionStats Chunk::compressionStats{};
+double Chunk::useTime = 0.0;
+
+namespace
+{
+	// Repeated sequences of runs are copied from up to 65535 bytes back (4 to 131 bytes at a time)
+	const std::size_t minMatch = 4u, maxMatch = minMatch + 0x7Fu, maxDistance = 0xFFFFu;
+
+	void CompressBlocks(const ChunkValues::BlockArray &blocks, std::vector<std::uint8_t> &result)
+	{
+		// Runs of the same block along each Y column as the block ID and run length (terrain is mostly in horizontal layers)
+		std::vector<std::uint8_t> runs;
+		runs.reserve(static_cast<std::size_t>(ChunkValues::sizeSquared) * 8u);
+		for (int x = 0; x < ChunkValues::size; ++x) {
+			for (int z = 0; z < ChunkValues::size; ++z) {
+				for (int y = 0; y < ChunkValues::size;) {
+					const ObjectID block = blocks.blocks[x][y][z];
+					int run = 1;
+					while (y + run < ChunkValues::size && blocks.blocks[x][y + run][z] == block) ++run;
+					runs.emplace_back(static_cast<std::uint8_t>(block));
+					runs.emplace_back(static_cast<std::uint8_t>(run));
+					y += run;
+				}
+			}
+		}
+
+		// Nearby columns usually have the same runs, so repeated sequences are replaced by the distance back to an earlier copy.
+		// Each token is either up to 128 bytes copied as they are (0 then count - 1) or a match (1 then length - minMatch) with the distance.
+		std::int32_t table[4096];
+		std::fill(table, table + Math::size(table), -1);
+		std::size_t literalStart{}, position{};
+
+		const auto AddLiterals = [&](std::size_t end) {
+			while (literalStart < end) {
+				const std::size_t count = glm::min(end - literalStart, std::size_t{ 0x80u });
+				result.emplace_back(static_cast<std::uint8_t>(count - 1u));
+				result.insert(result.end(), runs.begin() + static_cast<std::ptrdiff_t>(literalStart), runs.begin() + static_cast<std::ptrdiff_t>(literalStart + count));
+				literalStart += count;
+			}
+		};
+
+		while (position + minMatch <= runs.size()) {
+			std::uint32_t sequence;
+			std::memcpy(&sequence, runs.data() + position, sizeof(std::uint32_t));
+			std::int32_t &entry = table[(sequence * 2654435761u) >> 20u];
+			const std::size_t candidate = static_cast<std::size_t>(entry);
+			const bool found = entry >= 0 && position - candidate <= maxDistance && !std::memcmp(runs.data() + candidate, runs.data() + position, minMatch);
+			entry = static_cast<std::int32_t>(position);
+			if (!found) { ++position; continue; }
+
+			std::size_t length = minMatch;
+			while (length < maxMatch && position + length < runs.size() && runs[candidate + length] == runs[position + length]) ++length;
+			AddLiterals(position);
+
+			const std::size_t distance = position - candidate;
+			result.emplace_back(static_cast<std::uint8_t>(0x80u | (length - minMatch)));
+			result.emplace_back(static_cast<std::uint8_t>(distance & 0xFFu));
+			result.emplace_back(static_cast<std::uint8_t>(distance >> 8u));
+			position += length;
+			literalStart = position;
+		}
+		AddLiterals(runs.size());
+	}
+
+	bool DecompressBlocks(const std::uint8_t *data, std::size_t size, ChunkValues::BlockArray &blocks)
+	{
+		// Restore the runs first (matches can overlap themselves so they are copied in order)
+		std::vector<std::uint8_t> runs;
+		runs.reserve(static_cast<std::size_t>(ChunkValues::sizeSquared) * 8u);
+		for (std::size_t position{}; position < size;) {
+			const std::uint8_t token = data[position++];
+			if (!(token & 0x80u)) {
+				const std::size_t count = static_cast<std::size_t>(token) + 1u;
+				if (size - position < count) return false;
+				runs.insert(runs.end(), data + position, data + position + count);
+				position += count;
+				continue;
+			}
+
+			if (size - position < 2u) return false;
+			const std::size_t length = static_cast<std::size_t>(token & 0x7Fu) + minMatch;
+			const std::size_t distance = static_cast<std::size_t>(data[position]) | (static_cast<std::size_t>(data[position + 1u]) << 8u);
+			position += 2u;
+			if (!distance || distance > runs.size()) return false;
+			for (std::size_t i{}, start = runs.size() - distance; i < length; ++i) runs.emplace_back(runs[start + i]);
+		}
+
+		// Fill each Y column from its runs
+		std::size_t position{};
+		for (int x = 0; x < ChunkValues::size; ++x) {
+			for (int z = 0; z < ChunkValues::size; ++z) {
+				for (int y = 0; y < ChunkValues::size;) {
+					if (runs.size() - position < 2u) return false;
+					const ObjectID block = static_cast<ObjectID>(runs[position]);
+					const int run = static_cast<int>(runs[position + 1u]);
+					position += 2u;
+					if (!run || y + run > ChunkValues::size || block >= ObjectID::NumUnique) return false;
+					for (const int end = y + run; y < end; ++y) blocks.blocks[x][y][z] = block;
+				}
+			}
+		}
+		return position == runs.size();
+	}
+}
+
+void Chunk::ConstructChunk(const WorldPerlin::NoiseResult *perlinResults, BlockQueueMap &blockQueue) noexcept 
 {
-	this->offset = &offset; // Set temporary offset pointer (actual is set after full chunks finish generating)
-	const int worldCornerY = static_cast<int>(offset.y) * ChunkValues::size;
+	const int worldCornerY = static_cast<int>(offset->y) * ChunkValues::size;
 
 	// The chunk has not been created yet so initially use a full array
 	// and use an air chunk instead if no blocks are present after creation
@@ -56,6 +161,11 @@ void Chunk::ConstructChunk(const WorldPerlin::NoiseResult *perlinResults, BlockQ
 		delete chunkBlocks;
 		chunkBlocks = nullptr;
 	}
+	// Otherwise use the same blocks as any identical chunk (e.g. fully underground)
+	else if (blockPool.enabled) {
+		chunkBlocks = blockPool.Share(chunkBlocks);
+		sharedBlocks = true;
+	}
 }
 
 void Chunk::AttemptGenerateTree(BlockQueueMap &treeBlocksQueue, int x, int y, int z, const WorldPerlin::NoiseResult &noise, ObjectID logID, ObjectID leavesID) noexcept
@@ -137,17 +247,18 @@ bool Chunk::NoiseValueRand(const WorldPerlin::NoiseResult &noise, int oneInX) no
 	return !(mult % oneInX);
 }
 
-void Chunk::CalculateTerrainData(WorldMapDef &chunksMap) noexcept
+void Chunk::CalculateTerrainData() noexcept
 {
 	// To improve performance, the quad data is defined beforehand during chunk generation.
 	// However, the chunk faces are calculated in other scenarios (e.g. breaking and placing blocks) where this is not done.
 	std::uint32_t *quadData = new std::uint32_t[ChunkValues::blocksAmount];
-	CalculateTerrainData(chunksMap, quadData);
+	CalculateTerrainData(quadData);
 	delete[] quadData;
 }
 
-void Chunk::CalculateTerrainData(WorldMapDef &chunksMap, std::uint32_t *quadData) noexcept
+void Chunk::CalculateTerrainData(std::uint32_t *quadData) noexcept
 {
+	meshed = true; // Mark as calculated even if there are no faces
 	if (!chunkBlocks) return; // Don't calculate air chunks
 
 	// Store nearby chunks in an array for easier access (last index is current chunk)
@@ -155,9 +266,11 @@ void Chunk::CalculateTerrainData(WorldMapDef &chunksMap, std::uint32_t *quadData
 	localNearby[6] = chunkBlocks; // Last one points to this chunk
 
 	for (int i = 0; i < 6; ++i) {
-		const auto &foundChunkIt = chunksMap.find(*offset + game.constants.worldDirections[i]); // Look for a chunk in each direction
-		Chunk *foundChunk = foundChunkIt == chunksMap.end() ? nullptr : foundChunkIt->second; // Pointer to chunk or nullptr if none exists
+		const Chunk *foundChunk = nearbyChunks[i]; // Chunk in each direction (nullptr if none exists)
 		if (foundChunk && foundChunk->chunkBlocks) localNearby[i] = foundChunk->chunkBlocks; // Add blocks struct to nearby pointers if the chunk and its blocks exist
+		// Missing horizontal neighbours are treated as hidden (nullptr) as they are either not generated yet or past the render distance, 
+		// where those faces could only be seen from outside of the loaded area. This avoids remeshing when the neighbour is created later.
+		else if (!foundChunk && i != WldDir_Up && i != WldDir_Down) localNearby[i] = nullptr;
 		else localNearby[i] = &ChunkValues::emptyChunk;
 	}
 
@@ -166,9 +279,10 @@ void Chunk::CalculateTerrainData(WorldMapDef &chunksMap, std::uint32_t *quadData
 	for (int faceIndex = 0; faceIndex < 6; ++faceIndex) {
 		FaceAxisData &faceData = chunkFaceData[faceIndex];
 
-		// Reset any previous data
+		// Reset any previous data (including face data that was never buffered)
 		faceData.translucentFaceCount = std::uint16_t{};
 		faceData.faceCount = std::uint16_t{};
+		if (faceData.instancesData) { delete[] faceData.instancesData; faceData.instancesData = nullptr; }
 
 		// Loop through all the chunk's blocks for each face direction
 		for (int x = 0; x < ChunkValues::size; ++x) {
@@ -180,8 +294,11 @@ void Chunk::CalculateTerrainData(WorldMapDef &chunksMap, std::uint32_t *quadData
 				for (int z = 0; z < ChunkValues::size; ++z) {
 					const WorldBlockData &currentBlock = ChunkValues::GetBlockData(innerBlockArray[z]); // Get properties of the current block
 					const ChunkLookupData &nearbyData = chunkLookupData[lookupIndex++]; // Get precalculated results for the next block's position and face index
+					const ChunkValues::BlockArray *nearbyBlocks = localNearby[nearbyData.index];
+					if (!nearbyBlocks) continue; // Faces next to an unloaded neighbour are hidden
+
 					// Get the data of the block next to the current face, checking the correct chunk
-					const WorldBlockData &nextBlock =  ChunkValues::GetBlockData(localNearby[nearbyData.index]->at(nearbyData.pos));
+					const WorldBlockData &nextBlock =  ChunkValues::GetBlockData(nearbyBlocks->at(nearbyData.pos));
 					
 					// Check if the face is not obscured by the block found to be next to it
 					if (!currentBlock.notObscuredBy(currentBlock, nextBlock)) continue;
@@ -239,8 +356,188 @@ void Chunk::AllocateChunkBlocks() noexcept
 	std::memset(chunkBlocks->blocks, static_cast<int>(ObjectID::Air), sizeof(ChunkValues::BlockArray));
 }
 
+ChunkValues::BlockArray *Chunk::WritableBlocks() noexcept
+{
+	// Blocks need to be allocated (air chunk) or copied from the shared array before they can be changed
+	if (compressedBlocks) Decompress();
+	lastUsed = useTime;
+	if (!chunkBlocks) AllocateChunkBlocks();
+	else if (sharedBlocks) {
+		chunkBlocks = blockPool.Unshare(chunkBlocks);
+		sharedBlocks = false;
+	}
+	return chunkBlocks;
+}
+
+bool Chunk::HasAllNearby() const noexcept
+{
+	// Check if all four horizontal neighbours have been loaded
+	return nearbyChunks[WldDir_Right] && nearbyChunks[WldDir_Left] && nearbyChunks[WldDir_Front] && nearbyChunks[WldDir_Back];
+}
+
+bool Chunk::BorderNeedsUpdate(WorldDirection direction, const Chunk *nearbyChunk) const noexcept
+{
+	// Determine if the faces on the border plane shared with the given (newly loaded) nearby chunk would be any different to
+	// when the nearby chunk was missing, in which case those faces were treated as hidden. Most underground chunks have solid
+	// blocks on both sides of the border, so they do not need to be fully calculated again.
+	if (!chunkBlocks) return compressedBlocks != nullptr; // Air chunks have no faces (compressed chunks are calculated again to be safe)
+
+	const int axis = direction < WldDir_Up ? 0 : 2; // Axis of the shared plane (X or Z)
+	const int sideAxis = 2 - axis; // Other horizontal axis that runs along the plane
+	if (nearbyChunk->compressedBlocks) return true;
+	const ChunkValues::BlockArray *nearbyBlocks = nearbyChunk->chunkBlocks ? nearbyChunk->chunkBlocks : &ChunkValues::emptyChunk;
+
+	// Positive directions (right, front) have the border at the end of this chunk and the start of the nearby chunk
+	glm::ivec3 localPos{}, nearbyPos{};
+	localPos[axis] = (direction & 1) ? 0 : ChunkValues::sizeLess;
+	nearbyPos[axis] = ChunkValues::sizeLess - localPos[axis];
+
+	for (int side = 0; side < ChunkValues::size; ++side) {
+		localPos[sideAxis] = nearbyPos[sideAxis] = side;
+		for (int y = 0; y < ChunkValues::size; ++y) {
+			localPos.y = nearbyPos.y = y;
+			// Check if the face on the border would be visible with the now known nearby block
+			const WorldBlockData &currentBlock = ChunkValues::GetBlockData(chunkBlocks->at(localPos));
+			if (currentBlock.notObscuredBy(currentBlock, ChunkValues::GetBlockData(nearbyBlocks->at(nearbyPos)))) return true;
+		}
+	}
+
+	return false;
+}
+
+std::size_t Chunk::ResidentSize() const noexcept
+{
+	// Face data is only kept until it is added to the world buffers
+	std::size_t size = chunkBlocks && !sharedBlocks ? sizeof(ChunkValues::BlockArray) : static_cast<std::size_t>(compressedSize);
+	for (const FaceAxisData &faceData : chunkFaceData) if (faceData.instancesData) size += faceData.TotalFaces<std::size_t>() * sizeof(std::uint32_t);
+	return size;
+}
+
+bool Chunk::Compress() noexcept
+{
+	// Shared blocks are only compressed if no other chunk uses them (otherwise they are stored once anyway)
+	if (!chunkBlocks || (sharedBlocks && !blockPool.IsUnique(chunkBlocks))) return false;
+	std::vector<std::uint8_t> data;
+	CompressBlocks(*chunkBlocks, data);
+	if (data.size() > sizeof(ChunkValues::BlockArray) / 2u) return false; // Not worth decompressing later (e.g. varied builds)
+
+	if (sharedBlocks) blockPool.Release(chunkBlocks);
+	else delete chunkBlocks;
+	chunkBlocks = nullptr;
+	sharedBlocks = false;
+
+	compressedSize = static_cast<std::uint32_t>(data.size());
+	compressedBlocks = new std::uint8_t[data.size()];
+	std::memcpy(compressedBlocks, data.data(), data.size());
+	++compressionStats.chunks;
+	compressionStats.bytes += data.size();
+	++compressionStats.compressions;
+	return true;
+}
+
+void Chunk::Decompress() noexcept
+{
+	// Decompressed blocks are shared again like newly loaded chunks
+	const double start = glfwGetTime();
+	ChunkValues::BlockArray *blocks = new ChunkValues::BlockArray;
+	if (!DecompressBlocks(compressedBlocks, static_cast<std::size_t>(compressedSize), *blocks)) {
+		TextFormat::warn(fmt::format("Compressed blocks of chunk {} {} {} are invalid", offset->x, offset->y, offset->z), "Chunk decompression error");
+		std::memset(blocks->blocks, static_cast<int>(ObjectID::Air), sizeof(ChunkValues::BlockArray));
+	}
+	chunkBlocks = blockPool.enabled ? blockPool.Share(blocks) : blocks;
+	sharedBlocks = blockPool.enabled;
+
+	delete[] compressedBlocks;
+	compressedBlocks = nullptr;
+	--compressionStats.chunks;
+	compressionStats.bytes -= static_cast<std::size_t>(compressedSize);
+	compressedSize = std::uint32_t{};
+
+	const double time = glfwGetTime() - start;
+	++compressionStats.decompressions;
+	compressionStats.decompressTime += time;
+	compressionStats.maxDecompressTime = glm::max(compressionStats.maxDecompressTime, time);
+}
+
+void Chunk::CopyBlocks(ChunkValues::BlockArray &result) const noexcept
+{
+	if (chunkBlocks) std::memcpy(result.blocks, chunkBlocks->blocks, sizeof(ChunkValues::BlockArray));
+	else if (!compressedBlocks || !DecompressBlocks(compressedBlocks, static_cast<std::size_t>(compressedSize), result)) std::memset(result.blocks, static_cast<int>(ObjectID::Air), sizeof(ChunkValues::BlockArray));
+}
+
 Chunk::~Chunk()
 {
+	if (compressedBlocks) {
+		--compressionStats.chunks;
+		compressionStats.bytes -= static_cast<std::size_t>(compressedSize);
+		delete[] compressedBlocks;
+	}
 	for (FaceAxisData &fd : chunkFaceData) if (fd.instancesData) delete[] fd.instancesData; // Remove instance face data (if any)
-	if (chunkBlocks) delete chunkBlocks; // Delete chunk block data
+	if (sharedBlocks) blockPool.Release(chunkBlocks); // Deleted once no other chunks use it
+	else if (chunkBlocks) delete chunkBlocks; // Delete chunk block data
+}
+
+ChunkColumn::ChunkColumn(const WorldXZPosition &columnOffset) noexcept
+{
+	// Chunk offsets are stored in the column so each chunk only needs a pointer to its own
+	for (int y = 0; y < ChunkValues::heightCount; ++y) {
+		chunkOffsets[y] = { columnOffset.x, static_cast<PosType>(y), columnOffset.y };
+		chunks[y].offset = &chunkOffsets[y];
+		chunks[y].column = this;
+	}
+}
+
+void ChunkColumn::Generate(const WorldPerlin::NoiseResult *perlinResults, Chunk::BlockQueueMap &blockQueue) noexcept
+{
+	// Every chunk in the column uses the same noise results as they have the same XZ positions
+	for (Chunk &chunk : chunks) chunk.ConstructChunk(perlinResults, blockQueue);
+	for (int x = 0; x < ChunkValues::size; ++x) for (int z = 0; z < ChunkValues::size; ++z) UpdateHeight(x, z);
+}
+
+void ChunkColumn::UpdateHeight(int x, int z) noexcept
+{
+	// Search for the highest non-air block at the given local XZ position from the top of the column
+	for (int chunkY = ChunkValues::heightCount - 1; chunkY >= 0; --chunkY) {
+		// Only chunks on the world thread can be compressed (generating columns are not)
+		Chunk &chunk = chunks[chunkY];
+		if (chunk.IsAir()) continue;
+		const ChunkValues::BlockArray *chunkBlocks = chunk.compressedBlocks ? chunk.Blocks() : chunk.chunkBlocks;
+
+		for (int y = ChunkValues::sizeLess; y >= 0; --y) {
+			if (chunkBlocks->blocks[x][y][z] == ObjectID::Air) continue;
+			heightmap[x][z] = static_cast<std::uint16_t>((chunkY * ChunkValues::size) + y + 1);
+			return;
+		}
+	}
+
+	heightmap[x][z] = std::uint16_t{};
+}
+
+void ChunkColumn::BlockChanged(int x, int y, int z, bool isAir) noexcept
+{
+	// Keep the heightmap up to date with a changed block (Y position is relative to the bottom of the column)
+	std::uint16_t &height = heightmap[x][z];
+	if (!isAir && y >= static_cast<int>(height)) height = static_cast<std::uint16_t>(y + 1);
+	else if (isAir && y + 1 == static_cast<int>(height)) UpdateHeight(x, z); // Highest block was removed
+}
+
+int ChunkColumn::HighestChunk() const noexcept
+{
+	// Index of the highest chunk that has blocks (-1 if the column is all air)
+	int chunkY = ChunkValues::heightCount - 1;
+	while (chunkY >= 0 && chunks[chunkY].IsAir()) --chunkY;
+	return chunkY;
+}
+
+std::size_t ChunkColumn::ResidentSize() const noexcept
+{
+	std::size_t size = sizeof(ChunkColumn);
+	for (const Chunk &chunk : chunks) size += chunk.ResidentSize();
+	return size;
+}
+
+bool ChunkColumn::IsModified() const noexcept
+{
+	for (const Chunk &chunk : chunks) if (chunk.modified) return true;
+	return false;
 }
@@ -3,16 +3,20 @@
 #define _SOURCE_WORLD_CHUNK_HDR_
 
 #include "Generation/Settings.hpp"
+#include "ChunkMap.hpp"
+#include "BlockArrayPool.hpp"
+
+struct ChunkColumn;
 
 struct Chunk
 {
 public:
-	typedef std::unordered_map<WorldPosition, Chunk*, Math::WPHash> WorldMapDef;
+	typedef FlatPositionMap<Chunk*> WorldMapDef; // Local sets of chunks (main thread only)
+	typedef FlatPositionMap<ChunkColumn*> ColumnMapDef; // Map of all loaded columns (Y offset of 0)
 
 	enum class ChunkState : std::uint8_t
 	{
 		Normal,
-		Modified,
 		UpdateRequest
 	};
 
@@ -32,27 +36,92 @@ public:
 	};
 
 	typedef std::vector<BlockQueue> BlockQueueVector;
-	typedef std::unordered_map<WorldPosition, BlockQueueVector, Math::WPHash> BlockQueueMap;
+	typedef FlatPositionMap<BlockQueueVector> BlockQueueMap;
 	typedef BlockQueueMap::value_type BlockQueuePair;
 
-	ChunkValues::BlockArray *chunkBlocks = nullptr;
-	FaceAxisData chunkFaceData[6];
+	ChunkValues::BlockArray *chunkBlocks = nullptr; // Air and compressed chunks use nullptr (read only if shared - use WritableBlocks to change blocks)
+	FaceAxisData chunkFaceData[6]{};
 
 	const WorldPosition *offset;
+	ChunkColumn *column; // Column containing this chunk
 	ChunkState gameState = ChunkState::Normal;
+
+	Chunk *nearbyChunks[6]{}; // Loaded neighbouring chunks in each direction (WorldDirection index, nullptr if not loaded)
+
+	// Whether the chunk has had its terrain calculated at least once since being created
+	bool meshed = false;
+	bool sharedBlocks = false; // Block array is from the pool and could be used by other chunks
+	bool modified = false; // Blocks were changed after generation (the column is saved when unloaded)
+
+	// Blocks of chunks that have been unused and out of view for a while are compressed until they are used again (world thread only)
+	std::uint8_t *compressedBlocks = nullptr;
+	std::uint32_t compressedSize{};
+	double lastUsed = 0.0; // Time the blocks were last used or in view (0 if not known yet)
+
+	struct CompressionStats {
+		std::size_t chunks, bytes; // Chunks that are currently compressed and their total size
+		std::uintmax_t compressions, decompressions;
+		double decompressTime, maxDecompressTime; // Seconds
+		double Ratio() const noexcept { return bytes ? static_cast<double>(chunks * sizeof(ChunkValues::BlockArray)) / static_cast<double>(bytes) : 0.0; }
+		double AverageDecompressTime() const noexcept { return decompressions ? decompressTime / static_cast<double>(decompressions) : 0.0; }
+	};
+
+	static BlockArrayPool blockPool; // Identical block arrays of all chunks
+	static CompressionStats compressionStats;
+	static double useTime; // Given to chunks when their blocks are used (updated every frame)
 	
-	void ConstructChunk(const WorldPerlin::NoiseResult *perlinResults, BlockQueueMap &blockQueue, const WorldPosition offset) noexcept;
+	void ConstructChunk(const WorldPerlin::NoiseResult *perlinResults, BlockQueueMap &blockQueue) noexcept;
 	void AttemptGenerateTree(BlockQueueMap &treeBlocksQueue, int x, int y, int z, const WorldPerlin::NoiseResult &noise, ObjectID log, ObjectID leaves) noexcept;
 
 	void AddBlockQueue(BlockQueueMap &map, const WorldPosition &offset, const BlockQueue &queue);
 	
 	static bool NoiseValueRand(const WorldPerlin::NoiseResult &noise, int oneInX) noexcept;
 	
-	void CalculateTerrainData(WorldMapDef &chunksMap) noexcept;
-	void CalculateTerrainData(WorldMapDef &chunksMap, std::uint32_t *resultArray) noexcept;
+	void CalculateTerrainData() noexcept;
+	void CalculateTerrainData(std::uint32_t *resultArray) noexcept;
 	void AllocateChunkBlocks() noexcept;
+	ChunkValues::BlockArray *WritableBlocks() noexcept;
+
+	// Blocks for reading (decompressed first if needed, nullptr for air chunks)
+	const ChunkValues::BlockArray *Blocks() noexcept {
+		if (compressedBlocks) Decompress();
+		lastUsed = useTime;
+		return chunkBlocks;
+	}
+	bool IsAir() const noexcept { return !chunkBlocks && !compressedBlocks; }
+	bool Compress() noexcept;
+	void Decompress() noexcept;
+	void CopyBlocks(ChunkValues::BlockArray &result) const noexcept; // Without decompressing the chunk itself
+
+	std::size_t ResidentSize() const noexcept; // Memory used by the chunk's own data (shared blocks are counted in the pool)
+
+	bool HasAllNearby() const noexcept;
+	bool BorderNeedsUpdate(WorldDirection direction, const Chunk *nearbyChunk) const noexcept;
 
 	~Chunk();
 };
 
+// All of the chunks at an XZ offset - the world is loaded, stored and culled in full columns
+struct ChunkColumn
+{
+	ChunkColumn(const WorldXZPosition &columnOffset) noexcept;
+	ChunkColumn(const ChunkColumn&) = delete;
+	ChunkColumn &operator=(const ChunkColumn&) = delete;
+
+	Chunk chunks[ChunkValues::heightCount]; // Bottom to top
+	WorldPosition chunkOffsets[ChunkValues::heightCount]; // Offset of each chunk (pointed to by the chunks)
+	std::uint16_t heightmap[ChunkValues::size][ChunkValues::size]{}; // Y position above the highest non-air block at each local XZ position (0 if none)
+	bool saved = false; // Loaded from a region file instead of generated (already contains trees from nearby columns)
+	std::uint32_t lastVisible{}; // Last time the column was in view (world buffer sort count)
+
+	const WorldPosition &Offset() const noexcept { return chunkOffsets[0]; }
+
+	void Generate(const WorldPerlin::NoiseResult *perlinResults, Chunk::BlockQueueMap &blockQueue) noexcept;
+	void UpdateHeight(int x, int z) noexcept;
+	void BlockChanged(int x, int y, int z, bool isAir) noexcept;
+	int HighestChunk() const noexcept;
+	bool IsModified() const noexcept;
+	std::size_t ResidentSize() const noexcept;
+};
+
 #endif
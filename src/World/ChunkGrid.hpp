@@ -0,0 +1,80 @@
+#pragma once
+#ifndef _SOURCE_WORLD_CHUNKGRID_HDR_
+#define _SOURCE_WORLD_CHUNKGRID_HDR_
+
+#include "Chunk.hpp"
+
+// Ring buffer of column pointers indexed by column offset modulo the grid width. Loaded columns always
+// form a bounded area around the player, so each of them has its own slot as long as the grid is wider
+// than the loaded area - moving the center does not move any columns, only which offsets are 'inside'.
+// Columns are validated with their offset, and offsets outside the grid (or in a slot used by a column
+// about to be removed) need to be checked in the column map instead. Only used by the world update thread.
+class ChunkGrid
+{
+public:
+	ChunkGrid() noexcept {}
+	ChunkGrid(const ChunkGrid&) = delete;
+	ChunkGrid &operator=(const ChunkGrid&) = delete;
+	~ChunkGrid() { delete[] m_slots; }
+
+	// Create a grid that fits all columns within the given distance of the center (removes all columns)
+	void Resize(PosType distance) noexcept {
+		PosType width = static_cast<PosType>(1);
+		while (width < (distance * static_cast<PosType>(2)) + static_cast<PosType>(1)) width <<= 1;
+
+		if (width != m_width) {
+			delete[] m_slots;
+			m_width = width;
+			m_mask = width - static_cast<PosType>(1);
+			m_slots = new ChunkColumn*[static_cast<std::size_t>(width * width)];
+		}
+		Clear();
+	}
+
+	void Clear() noexcept { std::fill_n(m_slots, static_cast<std::size_t>(m_width * m_width), nullptr); }
+
+	// All columns in the grid must be within the distance given in Resize from the new center
+	void SetCenter(const WorldXZPosition &center) noexcept { m_center = center; }
+
+	void Insert(ChunkColumn *column) noexcept { 
+		const WorldXZPosition offset = { column->Offset().x, column->Offset().z };
+		if (m_slots && IsInside(offset)) m_slots[SlotIndex(offset)] = column; 
+	}
+	void Remove(const ChunkColumn *column) noexcept {
+		const WorldXZPosition offset = { column->Offset().x, column->Offset().z };
+		if (!m_slots || !IsInside(offset)) return;
+		ChunkColumn *&slot = m_slots[SlotIndex(offset)];
+		if (slot == column) slot = nullptr; // Slot could have been reused already
+	}
+
+	// Returns false if the column map needs to be checked instead, otherwise sets the result (nullptr if the column is not loaded)
+	bool Find(const WorldXZPosition &offset, ChunkColumn *&result) const noexcept {
+		if (!m_slots || !IsInside(offset)) return false;
+
+		ChunkColumn *column = m_slots[SlotIndex(offset)];
+		if (!column) { result = nullptr; return true; }
+		if (column->Offset().x != offset.x || column->Offset().z != offset.y) return false; // Different column in slot (outside of the grid, about to be removed)
+		result = column;
+		return true;
+	}
+
+	PosType Width() const noexcept { return m_width; }
+private:
+	bool IsInside(const WorldXZPosition &offset) const noexcept {
+		// The grid covers 'width' offsets in each axis with the center in the middle
+		const PosType half = m_width / static_cast<PosType>(2);
+		const PosType x = offset.x - m_center.x + half, z = offset.y - m_center.y + half;
+		return x >= PosType{} && x < m_width && z >= PosType{} && z < m_width;
+	}
+
+	std::size_t SlotIndex(const WorldXZPosition &offset) const noexcept {
+		// Wrap X and Z around the grid (works for negative offsets as the width is a power of 2)
+		return static_cast<std::size_t>(((offset.x & m_mask) * m_width) + (offset.y & m_mask));
+	}
+
+	ChunkColumn **m_slots = nullptr;
+	PosType m_width{}, m_mask{};
+	WorldXZPosition m_center{};
+};
+
+#endif // _SOURCE_WORLD_CHUNKGRID_HDR_
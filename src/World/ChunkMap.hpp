@@ -0,0 +1,171 @@
+#pragma once
+#ifndef _SOURCE_WORLD_CHUNKMAP_HDR_
+#define _SOURCE_WORLD_CHUNKMAP_HDR_
+
+#include "Generation/Settings.hpp"
+
+// Single-threaded map of world positions using open addressing (linear probing) with values stored
+// inline. Erased slots are marked as removed, so erasing whilst iterating is allowed.
+template<typename V>
+class FlatPositionMap
+{
+public:
+	typedef std::pair<const WorldPosition, V> value_type;
+private:
+	enum SlotState : std::uint8_t { SS_Empty, SS_Full, SS_Removed };
+	struct Slot {
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+		value_type &Value() noexcept { return *reinterpret_cast<value_type*>(&storage); }
+	};
+public:
+	template<typename T, typename M> struct Iterator {
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T *pointer;
+		typedef T &reference;
+
+		Iterator(M *map = nullptr, std::size_t slot = std::size_t{}) noexcept : m_map(map), m_slot(slot) { Advance(); }
+		template<typename U, typename N> Iterator(const Iterator<U, N> &other) noexcept : m_map(other.m_map), m_slot(other.m_slot) {}
+
+		T &operator*() const noexcept { return m_map->m_slots[m_slot].Value(); }
+		T *operator->() const noexcept { return &m_map->m_slots[m_slot].Value(); }
+		Iterator &operator++() noexcept { ++m_slot; Advance(); return *this; }
+		Iterator operator++(int) noexcept { Iterator it = *this; ++*this; return it; }
+		template<typename U, typename N> bool operator==(const Iterator<U, N> &other) const noexcept { return m_map == other.m_map && m_slot == other.m_slot; }
+		template<typename U, typename N> bool operator!=(const Iterator<U, N> &other) const noexcept { return !(*this == other); }
+	private:
+		template<typename> friend class FlatPositionMap;
+		template<typename, typename> friend struct Iterator;
+
+		void Advance() noexcept {
+			if (!m_map) return;
+			while (m_slot < m_map->m_capacity && m_map->m_states[m_slot] != SS_Full) ++m_slot;
+			if (m_slot >= m_map->m_capacity) { m_map = nullptr; m_slot = std::size_t{}; } // End iterator
+		}
+
+		M *m_map;
+		std::size_t m_slot;
+	};
+
+	typedef Iterator<value_type, FlatPositionMap> iterator;
+	typedef Iterator<const value_type, const FlatPositionMap> const_iterator;
+
+	FlatPositionMap() noexcept {}
+	FlatPositionMap(const FlatPositionMap&) = delete;
+	FlatPositionMap &operator=(const FlatPositionMap&) = delete;
+	~FlatPositionMap() { clear(); delete[] m_slots; delete[] m_states; }
+
+	iterator begin() noexcept { return iterator(this); }
+	iterator end() noexcept { return iterator(); }
+	const_iterator begin() const noexcept { return const_iterator(this); }
+	const_iterator end() const noexcept { return const_iterator(); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	std::size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return !m_size; }
+
+	iterator find(const WorldPosition &key) noexcept { const std::size_t slot = FindSlot(key); return slot == m_capacity ? end() : iterator(this, slot); }
+	const_iterator find(const WorldPosition &key) const noexcept { const std::size_t slot = FindSlot(key); return slot == m_capacity ? end() : const_iterator(this, slot); }
+	V Get(const WorldPosition &key, V fallback = V()) const { const std::size_t slot = FindSlot(key); return slot == m_capacity ? fallback : m_slots[slot].Value().second; }
+
+	std::pair<iterator, bool> insert(const value_type &value) {
+		const std::size_t found = FindSlot(value.first);
+		if (found != m_capacity) return { iterator(this, found), false };
+		const std::size_t slot = InsertSlot(value.first);
+		new (&m_slots[slot].storage) value_type(value);
+		return { iterator(this, slot), true };
+	}
+
+	V &operator[](const WorldPosition &key) {
+		std::size_t slot = FindSlot(key);
+		if (slot == m_capacity) {
+			slot = InsertSlot(key); // Could rehash
+			new (&m_slots[slot].storage) value_type(key, V());
+		}
+		return m_slots[slot].Value().second;
+	}
+
+	iterator erase(const_iterator it) noexcept {
+		const std::size_t slot = it.m_slot;
+		m_slots[slot].Value().~value_type();
+		m_states[slot] = SS_Removed;
+		--m_size; ++m_removed;
+		return iterator(this, slot + static_cast<std::size_t>(1u));
+	}
+	std::size_t erase(const WorldPosition &key) noexcept {
+		const std::size_t slot = FindSlot(key);
+		if (slot == m_capacity) return std::size_t{};
+		erase(const_iterator(this, slot));
+		return static_cast<std::size_t>(1u);
+	}
+
+	void clear() noexcept {
+		for (std::size_t i{}; i < m_capacity; ++i) {
+			if (m_states[i] == SS_Full) m_slots[i].Value().~value_type();
+			m_states[i] = SS_Empty;
+		}
+		m_size = m_removed = std::size_t{};
+	}
+
+	void reserve(std::size_t count) { if (count * static_cast<std::size_t>(10u) > m_capacity * static_cast<std::size_t>(7u)) Rehash(count * static_cast<std::size_t>(2u)); }
+private:
+	std::size_t FindSlot(const WorldPosition &key) const noexcept {
+		// Returns the capacity if the key is not found
+		if (!m_capacity) return m_capacity;
+		for (std::size_t slot = Math::WPHash()(key) & (m_capacity - static_cast<std::size_t>(1u));; slot = (slot + static_cast<std::size_t>(1u)) & (m_capacity - static_cast<std::size_t>(1u))) {
+			if (m_states[slot] == SS_Empty) return m_capacity;
+			if (m_states[slot] == SS_Full && m_slots[slot].Value().first == key) return slot;
+		}
+	}
+
+	std::size_t InsertSlot(const WorldPosition &key) {
+		// Grow (or clean up removed slots) before the table gets too full
+		if ((m_size + m_removed + static_cast<std::size_t>(1u)) * static_cast<std::size_t>(10u) > m_capacity * static_cast<std::size_t>(7u)) {
+			Rehash(m_size * static_cast<std::size_t>(4u) > m_capacity ? m_capacity * static_cast<std::size_t>(2u) : m_capacity);
+		}
+
+		std::size_t slot = Math::WPHash()(key) & (m_capacity - static_cast<std::size_t>(1u));
+		while (m_states[slot] == SS_Full) slot = (slot + static_cast<std::size_t>(1u)) & (m_capacity - static_cast<std::size_t>(1u));
+		if (m_states[slot] == SS_Removed) --m_removed;
+		m_states[slot] = SS_Full;
+		++m_size;
+		return slot;
+	}
+
+	void Rehash(std::size_t newCapacity) {
+		std::size_t powerOfTwo = static_cast<std::size_t>(16u);
+		while (powerOfTwo < newCapacity) powerOfTwo <<= 1u;
+
+		Slot *oldSlots = m_slots;
+		std::uint8_t *oldStates = m_states;
+		const std::size_t oldCapacity = m_capacity;
+
+		m_slots = new Slot[powerOfTwo];
+		m_states = new std::uint8_t[powerOfTwo]();
+		m_capacity = powerOfTwo;
+		m_size = m_removed = std::size_t{};
+
+		// Move values into the new slots
+		for (std::size_t i{}; i < oldCapacity; ++i) {
+			if (oldStates[i] != SS_Full) continue;
+			value_type &value = oldSlots[i].Value();
+			std::size_t slot = Math::WPHash()(value.first) & (m_capacity - static_cast<std::size_t>(1u));
+			while (m_states[slot] == SS_Full) slot = (slot + static_cast<std::size_t>(1u)) & (m_capacity - static_cast<std::size_t>(1u));
+			new (&m_slots[slot].storage) value_type(value.first, std::move(value.second));
+			m_states[slot] = SS_Full;
+			++m_size;
+			value.~value_type();
+		}
+
+		delete[] oldSlots;
+		delete[] oldStates;
+	}
+
+	Slot *m_slots = nullptr;
+	std::uint8_t *m_states = nullptr;
+	std::size_t m_capacity{}, m_size{}, m_removed{};
+};
+
+#endif // _SOURCE_WORLD_CHUNKMAP_HDR_
@@ -0,0 +1,93 @@
+#include "EditJournal.hpp"
+
+void EditJournal::Record(const WorldPosition &offset, const glm::ivec3 &localPos, ObjectID previous, ObjectID block) noexcept
+{
+	if (!memoryLimit) return;
+
+	// Blocks are changed chunk by chunk, so only the last chunk needs checking (a chunk appearing twice is still applied correctly)
+	if (m_current.empty() || m_current.back().offset != offset) {
+		m_current.emplace_back();
+		m_current.back().offset = offset;
+	}
+
+	// Extend the last run if the block is next to it in memory with the same change
+	std::vector<Run> &runs = m_current.back().runs;
+	const int index = LocalToIndex(localPos);
+	if (!runs.empty()) {
+		Run &last = runs.back();
+		if (last.start + last.count == index && last.previous == previous && last.block == block && last.count < std::numeric_limits<std::uint16_t>::max()) { ++last.count; return; }
+	}
+	const Run run = { static_cast<std::uint16_t>(index), static_cast<std::uint16_t>(1u), previous, block };
+	runs.emplace_back(run);
+}
+
+bool EditJournal::EndAction() noexcept
+{
+	if (m_current.empty()) return false;
+
+	// A new action replaces anything that was undone
+	for (const Action &action : m_redo) {
+		m_memorySize -= ActionSize(action);
+		m_blocksCount -= ActionBlocks(action);
+	}
+	m_redo.clear();
+
+	for (ChunkDiff &diff : m_current) diff.runs.shrink_to_fit();
+	m_current.shrink_to_fit();
+	m_memorySize += ActionSize(m_current);
+	m_blocksCount += ActionBlocks(m_current);
+	m_undo.emplace_back(std::move(m_current));
+	m_current = Action();
+
+	RemoveOldest();
+	return !m_undo.empty(); // Only removed if it is larger than the limit by itself
+}
+
+const EditJournal::Action *EditJournal::Undo() noexcept
+{
+	if (m_undo.empty()) return nullptr;
+	m_redo.emplace_back(std::move(m_undo.back()));
+	m_undo.pop_back();
+	return &m_redo.back();
+}
+
+const EditJournal::Action *EditJournal::Redo() noexcept
+{
+	if (m_redo.empty()) return nullptr;
+	m_undo.emplace_back(std::move(m_redo.back()));
+	m_redo.pop_back();
+	return &m_undo.back();
+}
+
+void EditJournal::Clear() noexcept
+{
+	m_undo.clear();
+	m_redo.clear();
+	m_current.clear();
+	m_memorySize = std::size_t{};
+	m_blocksCount = std::uintmax_t{};
+}
+
+void EditJournal::RemoveOldest() noexcept
+{
+	// Actions that can be redone are newer than any that can be undone, so they are kept
+	while (m_memorySize > memoryLimit && !m_undo.empty()) {
+		m_memorySize -= ActionSize(m_undo.front());
+		m_blocksCount -= ActionBlocks(m_undo.front());
+		m_undo.pop_front();
+	}
+}
+
+std::size_t EditJournal::ActionSize(const Action &action) noexcept
+{
+	std::size_t size = sizeof(Action) + (action.capacity() * sizeof(ChunkDiff));
+	for (const ChunkDiff &diff : action) size += diff.runs.capacity() * sizeof(Run);
+	return size;
+}
+
+std::uintmax_t EditJournal::ActionBlocks(const Action &action) noexcept
+{
+	std::uintmax_t count{};
+	for (const ChunkDiff &diff : action) for (const Run &run : diff.runs) count += run.count;
+	return count;
+}
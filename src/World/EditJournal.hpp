@@ -0,0 +1,59 @@
+#pragma once
+#ifndef _SOURCE_WORLD_EDITJOURNAL_HDR_
+#define _SOURCE_WORLD_EDITJOURNAL_HDR_
+
+#include "Generation/Settings.hpp"
+
+// Block changes grouped into actions (each block edit call, e.g. a fill command or a block placed by the player) that can
+// be undone and redone. Changes are stored per chunk as runs of blocks next to each other in memory with the same previous
+// and new block, so filling a large area only takes a few runs per chunk. The oldest actions are removed once the journal
+// is over its memory limit. Changes to unloaded chunks are not recorded as their previous blocks are unknown.
+class EditJournal
+{
+public:
+	struct Run {
+		std::uint16_t start, count; // Index of the first block in the chunk (same order as the block array)
+		ObjectID previous, block;
+	};
+	static_assert(ChunkValues::blocksAmount <= 65536, "Block indices in journal runs are stored as 16 bits.");
+
+	struct ChunkDiff {
+		WorldPosition offset;
+		std::vector<Run> runs; // Applied in order to redo and in reverse order to undo
+	};
+	typedef std::vector<ChunkDiff> Action;
+
+	EditJournal() noexcept {}
+	EditJournal(const EditJournal&) = delete;
+	EditJournal &operator=(const EditJournal&) = delete;
+
+	void Record(const WorldPosition &offset, const glm::ivec3 &localPos, ObjectID previous, ObjectID block) noexcept;
+	bool EndAction() noexcept; // Returns whether the recorded changes were kept (nothing to redo afterwards)
+
+	// Moves the last action to the other list, returning nullptr if there is none
+	const Action *Undo() noexcept;
+	const Action *Redo() noexcept;
+	void Clear() noexcept;
+
+	static int LocalToIndex(const glm::ivec3 &localPos) noexcept { return (localPos.x * ChunkValues::sizeSquared) + (localPos.y * ChunkValues::size) + localPos.z; }
+	static glm::ivec3 IndexToLocal(int index) noexcept { return { index / ChunkValues::sizeSquared, (index / ChunkValues::size) % ChunkValues::size, index % ChunkValues::size }; }
+
+	std::size_t UndoCount() const noexcept { return m_undo.size(); }
+	std::size_t RedoCount() const noexcept { return m_redo.size(); }
+	std::size_t MemorySize() const noexcept { return m_memorySize; }
+	std::uintmax_t BlocksCount() const noexcept { return m_blocksCount; }
+
+	std::size_t memoryLimit = 16u << 20u; // Bytes (0 to disable the journal)
+private:
+	static std::size_t ActionSize(const Action &action) noexcept;
+	static std::uintmax_t ActionBlocks(const Action &action) noexcept;
+	void RemoveOldest() noexcept;
+
+	std::deque<Action> m_undo;
+	std::vector<Action> m_redo;
+	Action m_current;
+	std::size_t m_memorySize{};
+	std::uintmax_t m_blocksCount{}; // Blocks changed by all kept actions
+};
+
+#endif // _SOURCE_WORLD_EDITJOURNAL_HDR_
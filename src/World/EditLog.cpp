@@ -0,0 +1,142 @@
+#include "EditLog.hpp"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char logMagic[4] = { 'B', 'C', 'E', 'L' };
+	const std::uint32_t logVersion = 2u;
+	const std::size_t logHeaderSize = sizeof(logMagic) + sizeof(std::uint32_t) + sizeof(std::int64_t); // Magic, version and world
+
+	// Whether the header is valid and from the given world (the rest of the file is not checked)
+	bool HeaderMatches(const std::uint8_t *header, std::size_t size, std::int64_t worldID) noexcept
+	{
+		if (size < logHeaderSize || std::memcmp(header, logMagic, sizeof(logMagic))) return false;
+		std::uint32_t version;
+		std::int64_t headerWorld;
+		std::memcpy(&version, header + sizeof(logMagic), sizeof(std::uint32_t));
+		std::memcpy(&headerWorld, header + sizeof(logMagic) + sizeof(std::uint32_t), sizeof(std::int64_t));
+		return version == logVersion && headerWorld == worldID;
+	}
+
+	bool SyncStream(std::FILE *file) noexcept
+	{
+		if (std::fflush(file)) return false;
+		#if defined(_WIN32)
+		return !_commit(_fileno(file));
+		#else
+		return !fsync(fileno(file));
+		#endif
+	}
+}
+
+bool EditLog::Open(const std::string &path, std::int64_t worldID, bool replace, const std::vector<Edit> &edits) noexcept
+{
+	if (!replace) {
+		if (m_file) return true;
+
+		// New logs and logs from other worlds (or invalid ones) are started again with just the header
+		std::uint8_t header[logHeaderSize]{};
+		std::ifstream existing(path, std::ios::binary);
+		existing.read(reinterpret_cast<char*>(header), static_cast<std::streamsize>(logHeaderSize));
+		if (!HeaderMatches(header, static_cast<std::size_t>(existing.gcount()), worldID)) return Open(path, worldID, true, std::vector<Edit>());
+
+		m_file = std::fopen(path.c_str(), "ab");
+		return m_file != nullptr;
+	}
+
+	// Write the new log separately first so the previous one is kept if writing fails
+	Close();
+	const std::string tempPath = path + ".tmp";
+	m_file = std::fopen(tempPath.c_str(), "wb");
+	if (!m_file) return false;
+	const bool written = WriteHeader(worldID) && Append(edits) && SyncStream(m_file);
+	Close();
+
+	std::remove(path.c_str()); // Renaming does not replace existing files on Windows
+	if (!written || std::rename(tempPath.c_str(), path.c_str())) return false;
+	return Open(path, worldID, false, edits);
+}
+
+void EditLog::Close() noexcept
+{
+	if (m_file) std::fclose(m_file);
+	m_file = nullptr;
+}
+
+bool EditLog::Append(const std::vector<Edit> &edits) noexcept
+{
+	// Encode all changes first so they are written at once
+	std::vector<std::uint8_t> data(edits.size() * editSize);
+	for (std::size_t i{}; i < edits.size(); ++i) Encode(edits[i], data.data() + (i * editSize));
+	return std::fwrite(data.data(), std::size_t{ 1u }, data.size(), m_file) == data.size();
+}
+
+bool EditLog::Sync() noexcept
+{
+	return m_file && SyncStream(m_file);
+}
+
+bool EditLog::Read(const std::string &path, std::int64_t worldID, std::vector<Edit> &edits) noexcept
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.good()) return false;
+
+	const std::size_t fileSize = static_cast<std::size_t>(file.tellg());
+	std::vector<std::uint8_t> data(fileSize);
+	file.seekg(std::ios::beg);
+	file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(fileSize));
+
+	if (!file.good() || !HeaderMatches(data.data(), fileSize, worldID)) {
+		TextFormat::warn(fmt::format("Edit log '{}' is invalid or from another world (not applied)", path), "Edit log read error");
+		return false;
+	}
+
+	// The last change could have been partly written if the game stopped whilst writing it
+	for (std::size_t position = logHeaderSize; position + editSize <= fileSize; position += editSize) {
+		const std::uint8_t *entry = data.data() + position;
+		Edit edit;
+		std::memcpy(&edit.position.x, entry, sizeof(std::int64_t));
+		std::memcpy(&edit.position.z, entry + sizeof(std::int64_t), sizeof(std::int64_t));
+		edit.position.y = static_cast<PosType>(entry[16]);
+		edit.oldBlock = static_cast<ObjectID>(entry[17]);
+		edit.newBlock = static_cast<ObjectID>(entry[18]);
+		if (edit.oldBlock > ObjectID::NumUnique || edit.newBlock >= ObjectID::NumUnique) continue;
+		edits.emplace_back(edit);
+	}
+	return true;
+}
+
+bool EditLog::SyncFile(const std::string &path) noexcept
+{
+	std::FILE *file = std::fopen(path.c_str(), "ab");
+	if (!file) return false;
+	const bool synced = SyncStream(file);
+	std::fclose(file);
+	return synced;
+}
+
+void EditLog::Encode(const Edit &edit, std::uint8_t *data) noexcept
+{
+	static_assert(ChunkValues::maxHeight <= 256, "Edit log stores Y positions as 1 byte.");
+	const std::int64_t x = static_cast<std::int64_t>(edit.position.x), z = static_cast<std::int64_t>(edit.position.z);
+	std::memcpy(data, &x, sizeof(std::int64_t));
+	std::memcpy(data + sizeof(std::int64_t), &z, sizeof(std::int64_t));
+	data[16] = static_cast<std::uint8_t>(edit.position.y);
+	data[17] = static_cast<std::uint8_t>(edit.oldBlock);
+	data[18] = static_cast<std::uint8_t>(edit.newBlock);
+}
+
+bool EditLog::WriteHeader(std::int64_t worldID) noexcept
+{
+	std::uint8_t header[logHeaderSize];
+	std::memcpy(header, logMagic, sizeof(logMagic));
+	std::memcpy(header + sizeof(logMagic), &logVersion, sizeof(std::uint32_t));
+	std::memcpy(header + sizeof(logMagic) + sizeof(std::uint32_t), &worldID, sizeof(std::int64_t));
+	return std::fwrite(header, std::size_t{ 1u }, logHeaderSize, m_file) == logHeaderSize;
+}
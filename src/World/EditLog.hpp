@@ -0,0 +1,44 @@
+#pragma once
+#ifndef _SOURCE_WORLD_EDITLOG_HDR_
+#define _SOURCE_WORLD_EDITLOG_HDR_
+
+#include "Generation/Settings.hpp"
+
+// Append-only file of block changes made since the last checkpoint (when all changed columns were saved to region
+// files), so changes are kept if the game closes before they are saved. Each change only uses a few bytes and is
+// written to the end of the file, with many changes synced to the disk at once. The header holds the world the changes
+// were made in (its seed) so they are never applied to a different world.
+class EditLog
+{
+public:
+	struct Edit {
+		WorldPosition position;
+		ObjectID oldBlock, newBlock; // Old block is NumUnique if it was not loaded
+	};
+	static constexpr std::size_t editSize = (sizeof(std::int64_t) * 2u) + 3u; // X and Z, then Y and both blocks as 1 byte
+
+	EditLog() noexcept {}
+	EditLog(const EditLog&) = delete;
+	EditLog &operator=(const EditLog&) = delete;
+	~EditLog() { Close(); }
+
+	// Opens the log for adding changes, replacing it with the given changes if requested (e.g. after a checkpoint).
+	// An existing log from another world is replaced.
+	bool Open(const std::string &path, std::int64_t worldID, bool replace, const std::vector<Edit> &edits) noexcept;
+	bool IsOpen() const noexcept { return m_file != nullptr; }
+	void Close() noexcept;
+
+	bool Append(const std::vector<Edit> &edits) noexcept;
+	bool Sync() noexcept; // Waits until everything written is on the disk
+
+	// Reads all changes in the log (ignoring any partly written change at the end), false if it is from another world
+	static bool Read(const std::string &path, std::int64_t worldID, std::vector<Edit> &edits) noexcept;
+	static bool SyncFile(const std::string &path) noexcept;
+private:
+	static void Encode(const Edit &edit, std::uint8_t *data) noexcept;
+	bool WriteHeader(std::int64_t worldID) noexcept;
+
+	std::FILE *m_file = nullptr;
+};
+
+#endif // _SOURCE_WORLD_EDITLOG_HDR_
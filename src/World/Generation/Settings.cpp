@@ -3,6 +3,46 @@
 PosType ChunkValues::ToWorld(double x) noexcept { return static_cast<PosType>(glm::floor(x)); }
 PosType ChunkValues::ToWorld(float  x) noexcept { return static_cast<PosType>(glm::floor(x)); }
 
+void ChunkValues::WorldToOffsetLocal(const WorldPosition *positions, std::size_t count, WorldPosition *offsets, glm::ivec3 *localPositions) noexcept
+{
+	// Shift and mask each axis (no branches, so the loop can be vectorized)
+	const PosType mask = static_cast<PosType>(sizeLess);
+	for (std::size_t i{}; i < count; ++i) {
+		const WorldPosition &pos = positions[i];
+		offsets[i] = { pos.x >> sizeBits, pos.y >> sizeBits, pos.z >> sizeBits };
+		localPositions[i] = { static_cast<int>(pos.x & mask), static_cast<int>(pos.y & mask), static_cast<int>(pos.z & mask) };
+	}
+}
+
+std::size_t ChunkValues::GroupByChunk(const WorldPosition *offsets, std::size_t count, std::uint32_t *order) noexcept
+{
+	// Sort indexes by offset so positions in the same chunk are next to each other (stable so the order
+	// within a chunk stays the same), then count how many times the offset changes
+	const auto Less = [&](std::uint32_t a, std::uint32_t b) {
+		const WorldPosition &first = offsets[a], &second = offsets[b];
+		if (first.x != second.x) return first.x < second.x;
+		if (first.z != second.z) return first.z < second.z;
+		return first.y < second.y;
+	};
+	for (std::uint32_t i{}; i < static_cast<std::uint32_t>(count); ++i) order[i] = i;
+
+	// Small batches (e.g. collision checks) use an insertion sort in place, as stable_sort allocates a buffer
+	constexpr std::size_t insertionCount = 64u;
+	if (count <= insertionCount) {
+		for (std::size_t i = 1u; i < count; ++i) {
+			const std::uint32_t index = order[i];
+			std::size_t j = i;
+			for (; j && Less(index, order[j - 1u]); --j) order[j] = order[j - 1u];
+			order[j] = index;
+		}
+	}
+	else std::stable_sort(order, order + count, Less);
+
+	std::size_t groups = count ? static_cast<std::size_t>(1u) : std::size_t{};
+	for (std::size_t i = 1u; i < count; ++i) if (offsets[order[i]] != offsets[order[i - 1u]]) ++groups;
+	return groups;
+}
+
 bool ChunkValues::IsOnCorner(const glm::ivec3 &pos, WorldDirection dir) noexcept
 {
 	const int val = dir < 2 ? pos.x : dir < 4 ? pos.y : pos.z; // Determine if the direction is the X, Y or Z axis
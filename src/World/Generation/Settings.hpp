@@ -195,22 +195,23 @@ namespace ChunkValues
 		return { ToWorld(vec.x), ToWorld(vec.y), ToWorld(vec.z) };
 	}
 	
-	template<typename T> PosType WorldToOffset(T x) noexcept {
-		const PosType v = ToWorld(x);
-		const PosType a = v < PosType{} ? v - static_cast<PosType>(sizeLess) : v;
-		return (a - (a % static_cast<PosType>(size))) / static_cast<PosType>(size);
-	}
+	// The chunk size is a power of 2, so an arithmetic shift gives the (floored) chunk offset
+	// and a mask gives the local position for both positive and negative positions
+	template<typename T> PosType WorldToOffset(T x) noexcept { return ToWorld(x) >> sizeBits; }
 	template<typename T, glm::qualifier Q> WorldPosition WorldToOffset(const glm::vec<3, T, Q> &pos) noexcept {
 		return { WorldToOffset(pos.x), WorldToOffset(pos.y), WorldToOffset(pos.z) };
 	}
 	
-	template<typename T> int WorldToLocal(T x) noexcept {
-		return static_cast<int>(static_cast<PosType>(x) - (static_cast<PosType>(size) * WorldToOffset(x)));
-	}
+	template<typename T> int WorldToLocal(T x) noexcept { return static_cast<int>(ToWorld(x) & static_cast<PosType>(sizeLess)); }
 	template<typename T, glm::qualifier Q> glm::ivec3 WorldToLocal(const glm::vec<3, T, Q> &pos) noexcept {
 		return { WorldToLocal(pos.x), WorldToLocal(pos.y), WorldToLocal(pos.z) };
 	}
 	
+	// Batch versions - convert arrays of world positions, and order positions so ones in the same chunk are next to each other
+	// (fills 'order' with position indexes and returns the number of different chunks) so each chunk only needs finding once
+	void WorldToOffsetLocal(const WorldPosition *positions, std::size_t count, WorldPosition *offsets, glm::ivec3 *localPositions) noexcept;
+	std::size_t GroupByChunk(const WorldPosition *offsets, std::size_t count, std::uint32_t *order) noexcept;
+	
 	bool IsOnCorner(const glm::ivec3 &pos, WorldDirection dir) noexcept;
 
 	struct BlockArray {
@@ -220,6 +221,7 @@ namespace ChunkValues
 	} const emptyChunk{};
 
 	static_assert(!(worldHeight % size), "The world height must be a multiple of the chunk size.");
+	static_assert(size == (1 << sizeBits), "The chunk size must be 2 to the power of 'sizeBits'.");
 };
 
 struct ChunkLookupData
@@ -0,0 +1,94 @@
+#include "MappedFile.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const std::string &path, bool mapped) noexcept
+{
+	Close();
+	if (mapped && Map(path)) return true;
+
+	// Read the entire file into the buffer instead
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.good()) return false;
+	m_buffer.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(std::ios::beg);
+	file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+	if (!file.good()) { m_buffer.clear(); return false; }
+
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+	return true;
+}
+
+void MappedFile::Close() noexcept
+{
+	if (m_mapping) {
+		#if defined(_WIN32)
+		UnmapViewOfFile(m_mapping);
+		CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+		#else
+		munmap(m_mapping, m_size);
+		#endif
+	}
+
+	m_mapping = m_mappingHandle = nullptr;
+	m_data = nullptr;
+	m_size = std::size_t{};
+	m_buffer.clear();
+}
+
+bool MappedFile::Map(const std::string &path) noexcept
+{
+	// Empty files cannot be mapped (and would not be valid anyway)
+	#if defined(_WIN32)
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+	CloseHandle(file); // The mapping keeps the file open
+	if (!mapping) return false;
+
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0u, 0u, 0u);
+	if (!view) { CloseHandle(mapping); return false; }
+	m_mappingHandle = mapping;
+	m_size = static_cast<std::size_t>(fileSize.QuadPart);
+	#else
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat fileInfo;
+	void *view = MAP_FAILED;
+	if (!fstat(file, &fileInfo) && fileInfo.st_size > 0) view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); // The mapping keeps the file open
+	if (view == MAP_FAILED) return false;
+	m_size = static_cast<std::size_t>(fileInfo.st_size);
+	#endif
+
+	m_mapping = view;
+	m_data = static_cast<const std::uint8_t*>(view);
+	return true;
+}
+
+bool MappedFile::Evict(const std::string &path) noexcept
+{
+	#if defined(POSIX_FADV_DONTNEED)
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+	const bool evicted = !posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+	close(file);
+	return evicted;
+	#else
+	static_cast<void>(path);
+	return false;
+	#endif
+}
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef _SOURCE_WORLD_MAPPEDFILE_HDR_
+#define _SOURCE_WORLD_MAPPEDFILE_HDR_
+
+#include "Application/Definitions.hpp"
+
+// Read-only view of an entire file, either memory-mapped (only the pages that are used get read, through the
+// page cache) or read into a buffer. Buffered reads are also used if the file could not be mapped.
+class MappedFile
+{
+public:
+	MappedFile() noexcept {}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile &operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const std::string &path, bool mapped) noexcept;
+	void Close() noexcept;
+
+	const std::uint8_t *Data() const noexcept { return m_data; }
+	std::size_t Size() const noexcept { return m_size; }
+	bool IsMapped() const noexcept { return m_mapping != nullptr; }
+
+	// Removes the file from the page cache so the next read comes from the disk (false if not supported)
+	static bool Evict(const std::string &path) noexcept;
+private:
+	bool Map(const std::string &path) noexcept;
+
+	const std::uint8_t *m_data = nullptr;
+	std::size_t m_size{};
+	void *m_mapping = nullptr; // Mapped view (nullptr if buffered)
+	void *m_mappingHandle = nullptr; // Windows file mapping object
+	std::vector<std::uint8_t> m_buffer;
+};
+
+#endif // _SOURCE_WORLD_MAPPEDFILE_HDR_
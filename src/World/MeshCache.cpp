@@ -0,0 +1,324 @@
+#include "MeshCache.hpp"
+
+namespace
+{
+	const char diskMagic[4] = { 'B', 'C', 'M', 'C' };
+	const std::uint32_t diskVersion = 1u;
+	const std::size_t diskHeaderSize = sizeof(diskMagic) + sizeof(std::uint32_t);
+
+	std::uint64_t Mix(std::uint64_t hash, std::uint64_t value) noexcept
+	{
+		hash = (hash ^ value) * 0xC2B2AE3D27D4EB4Full;
+		return hash ^ (hash >> 29u);
+	}
+
+	std::uint64_t BlockDataHash() noexcept
+	{
+		// Faces also depend on the textures and transparency of each block, which could be different in meshes from the disk
+		std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+		for (int id = 0; id < static_cast<int>(ObjectID::NumUnique); ++id) {
+			const WorldBlockData &data = ChunkValues::GetBlockData(static_cast<ObjectID>(id));
+			for (const std::uint8_t texture : data.textures) hash = Mix(hash, texture);
+			hash = Mix(hash, data.hasTransparency);
+		}
+		return hash;
+	}
+}
+
+MeshCache::~MeshCache()
+{
+	// Kept for the next game
+	if (m_diskFile) for (const auto &it : m_entries) if (!it.second.onDisk) WriteDisk(it.first, it.second);
+	CloseDisk();
+}
+
+MeshCache::Key MeshCache::ChunkKey(const Chunk &chunk) noexcept
+{
+	static_assert(!(sizeof(ChunkValues::BlockArray) % sizeof(std::uint64_t)), "Block arrays are hashed 8 bytes at a time.");
+	static const std::uint64_t blockDataHash = BlockDataHash();
+
+	// All blocks of the chunk, 8 at a time
+	const unsigned char *bytes = reinterpret_cast<const unsigned char*>(chunk.chunkBlocks->blocks);
+	std::uint64_t hash = blockDataHash;
+	for (std::size_t i{}; i < sizeof(ChunkValues::BlockArray); i += sizeof(std::uint64_t)) {
+		std::uint64_t word;
+		std::memcpy(&word, bytes + i, sizeof(std::uint64_t));
+		hash = Mix(hash, word);
+	}
+
+	// Only the plane of blocks touching the chunk in each direction affects its faces. Faces next to missing horizontal
+	// neighbours are hidden, whilst missing vertical neighbours are the same as air chunks.
+	for (int direction = 0; direction < 6; ++direction) {
+		const Chunk *nearbyChunk = chunk.nearbyChunks[direction];
+		if (!nearbyChunk || !nearbyChunk->chunkBlocks) {
+			const bool hidden = !nearbyChunk && direction != WldDir_Up && direction != WldDir_Down;
+			hash = Mix(hash, hidden ? 1u : 2u);
+			continue;
+		}
+
+		// Positive directions touch the start of the nearby chunk and negative directions touch the end
+		const int axis = direction >> 1, first = axis ? 0 : 1, second = axis == 2 ? 1 : 2;
+		glm::ivec3 pos{};
+		pos[axis] = (direction & 1) ? ChunkValues::sizeLess : 0;
+
+		std::uint64_t word = 3u;
+		int count = 0;
+		for (pos[first] = 0; pos[first] < ChunkValues::size; ++pos[first]) {
+			for (pos[second] = 0; pos[second] < ChunkValues::size; ++pos[second]) {
+				word = (word << 8u) | static_cast<std::uint64_t>(nearbyChunk->chunkBlocks->at(pos));
+				if (!(++count & 7)) hash = Mix(hash, word);
+			}
+		}
+	}
+
+	return hash;
+}
+
+bool MeshCache::Find(Key key, Chunk &chunk) noexcept
+{
+	if (!memoryLimit) return false;
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto found = m_entries.find(key);
+	if (found != m_entries.end()) {
+		++hits;
+		Unlink(found->second);
+	}
+	else {
+		// Meshes found on the disk are kept in memory again
+		Entry entry;
+		if (!m_diskFile || !ReadDisk(key, entry)) { ++misses; return false; }
+		found = m_entries.emplace(key, std::move(entry)).first;
+		found->second.key = key;
+		m_memorySize += EntrySize(found->second);
+		++diskHits;
+	}
+
+	LinkNewest(found->second);
+	GiveFaces(found->second, chunk);
+	if (m_memorySize > memoryLimit) RemoveOldest();
+	return true;
+}
+
+void MeshCache::Add(Key key, const Chunk &chunk) noexcept
+{
+	if (!memoryLimit) return;
+
+	// Opaque and translucent faces are stored together in each direction (same as the chunk)
+	Entry entry;
+	std::size_t totalFaces{};
+	for (int faceIndex = 0; faceIndex < 6; ++faceIndex) {
+		const Chunk::FaceAxisData &faceData = chunk.chunkFaceData[faceIndex];
+		entry.faceCounts[faceIndex][0] = faceData.faceCount;
+		entry.faceCounts[faceIndex][1] = faceData.translucentFaceCount;
+		totalFaces += faceData.TotalFaces<std::size_t>();
+	}
+	entry.faces.reserve(totalFaces);
+	for (const Chunk::FaceAxisData &faceData : chunk.chunkFaceData) {
+		if (faceData.instancesData) entry.faces.insert(entry.faces.end(), faceData.instancesData, faceData.instancesData + faceData.TotalFaces<std::size_t>());
+	}
+	entry.onDisk = false;
+
+	entry.key = key;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const std::size_t size = EntrySize(entry);
+	const auto added = m_entries.emplace(key, std::move(entry));
+	if (!added.second) return; // Added by another thread
+	LinkNewest(added.first->second);
+	m_memorySize += size;
+	if (m_memorySize > memoryLimit) RemoveOldest();
+}
+
+void MeshCache::SetDiskPath(const std::string &path) noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CloseDisk();
+	m_diskPath = path;
+	if (path.empty()) return;
+
+	// Create the directories containing the file first
+	try {
+		for (std::size_t end = path.find('/'); end != std::string::npos; end = path.find('/', end + 1u)) {
+			const std::string directory = path.substr(std::size_t{}, end);
+			if (!directory.empty() && !FileManager::DirectoryExists(directory)) FileManager::CreatePath(directory);
+		}
+	} catch (const FileManager::FileError &error) {
+		TextFormat::warn(error.what(), "Mesh cache error");
+		return;
+	}
+	OpenDisk(false);
+}
+
+void MeshCache::Clear() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+	m_oldest = m_newest = nullptr;
+	m_memorySize = std::size_t{};
+}
+
+double MeshCache::HitRate() const noexcept
+{
+	// Percentage of chunks that did not need calculating
+	const std::uintmax_t found = hits + diskHits, total = found + misses;
+	return total ? (static_cast<double>(found) / static_cast<double>(total)) * 100.0 : 0.0;
+}
+
+std::size_t MeshCache::Count() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+void MeshCache::GiveFaces(const Entry &entry, Chunk &chunk) noexcept
+{
+	// Same result as calculating the chunk's faces
+	chunk.meshed = true;
+	const std::uint32_t *faces = entry.faces.data();
+	for (int faceIndex = 0; faceIndex < 6; ++faceIndex) {
+		Chunk::FaceAxisData &faceData = chunk.chunkFaceData[faceIndex];
+		if (faceData.instancesData) { delete[] faceData.instancesData; faceData.instancesData = nullptr; }
+		faceData.faceCount = entry.faceCounts[faceIndex][0];
+		faceData.translucentFaceCount = entry.faceCounts[faceIndex][1];
+
+		const std::size_t totalFaces = faceData.TotalFaces<std::size_t>();
+		if (!totalFaces) continue;
+		faceData.instancesData = new std::uint32_t[totalFaces];
+		std::memcpy(faceData.instancesData, faces, totalFaces * sizeof(std::uint32_t));
+		faces += totalFaces;
+	}
+}
+
+void MeshCache::Unlink(Entry &entry) noexcept
+{
+	(entry.older ? entry.older->newer : m_oldest) = entry.newer;
+	(entry.newer ? entry.newer->older : m_newest) = entry.older;
+}
+
+void MeshCache::LinkNewest(Entry &entry) noexcept
+{
+	entry.older = m_newest;
+	entry.newer = nullptr;
+	(m_newest ? m_newest->newer : m_oldest) = &entry;
+	m_newest = &entry;
+}
+
+void MeshCache::RemoveOldest() noexcept
+{
+	// Meshes are removed until a quarter of the limit is free so this is not needed for every new mesh
+	const std::size_t limit = memoryLimit, target = limit - (limit / static_cast<std::size_t>(4u));
+	while (m_oldest && m_memorySize > target) {
+		Entry &oldest = *m_oldest;
+		if (m_diskFile && !oldest.onDisk) WriteDisk(oldest.key, oldest);
+		m_memorySize -= EntrySize(oldest);
+		Unlink(oldest);
+		m_entries.erase(oldest.key);
+	}
+	if (m_diskFile) std::fflush(m_diskFile);
+}
+
+bool MeshCache::OpenDisk(bool replace) noexcept
+{
+	// Find every mesh in an existing file, or start a new file if it is invalid (or being replaced)
+	CloseDisk();
+	m_diskEntries.clear();
+	m_diskSize = std::size_t{};
+
+	if (!replace && (m_diskFile = std::fopen(m_diskPath.c_str(), "r+b")) != nullptr) {
+		std::fseek(m_diskFile, 0, SEEK_END);
+		const std::size_t fileSize = static_cast<std::size_t>(std::ftell(m_diskFile));
+		std::fseek(m_diskFile, 0, SEEK_SET);
+
+		std::uint8_t header[diskHeaderSize]{};
+		std::uint32_t version{};
+		if (fileSize >= diskHeaderSize && std::fread(header, std::size_t{ 1u }, diskHeaderSize, m_diskFile) == diskHeaderSize) std::memcpy(&version, header + sizeof(diskMagic), sizeof(std::uint32_t));
+		if (!std::memcmp(header, diskMagic, sizeof(diskMagic)) && version == diskVersion) {
+			// The last mesh could have been partly written (replaced by the next one)
+			std::size_t position = diskHeaderSize;
+			std::uint8_t entryHeader[entryHeaderSize];
+			while (position + entryHeaderSize <= fileSize && std::fread(entryHeader, std::size_t{ 1u }, entryHeaderSize, m_diskFile) == entryHeaderSize) {
+				Key key;
+				std::uint16_t faceCounts[6][2];
+				std::memcpy(&key, entryHeader, sizeof(Key));
+				std::memcpy(faceCounts, entryHeader + sizeof(Key), sizeof(faceCounts));
+				std::size_t totalFaces{};
+				for (const std::uint16_t (&counts)[2] : faceCounts) totalFaces += static_cast<std::size_t>(counts[0]) + static_cast<std::size_t>(counts[1]);
+
+				const std::size_t entrySize = entryHeaderSize + (totalFaces * sizeof(std::uint32_t));
+				if (position + entrySize > fileSize) break;
+				m_diskEntries[key] = static_cast<std::uint64_t>(position);
+				position += entrySize;
+				std::fseek(m_diskFile, static_cast<long>(position), SEEK_SET);
+			}
+
+			m_diskSize = position;
+			for (auto &it : m_entries) it.second.onDisk = m_diskEntries.count(it.first) != 0u;
+			return true;
+		}
+		TextFormat::warn(fmt::format("Mesh cache '{}' is invalid", m_diskPath), "Mesh cache error");
+		CloseDisk();
+		m_diskEntries.clear();
+	}
+
+	m_diskFile = std::fopen(m_diskPath.c_str(), "w+b");
+	if (!m_diskFile) {
+		TextFormat::warn(fmt::format("Mesh cache '{}' could not be created", m_diskPath), "Mesh cache error");
+		return false;
+	}
+
+	std::uint8_t header[diskHeaderSize];
+	std::memcpy(header, diskMagic, sizeof(diskMagic));
+	std::memcpy(header + sizeof(diskMagic), &diskVersion, sizeof(std::uint32_t));
+	std::fwrite(header, std::size_t{ 1u }, diskHeaderSize, m_diskFile);
+	m_diskSize = diskHeaderSize;
+	for (auto &it : m_entries) it.second.onDisk = false;
+	return true;
+}
+
+void MeshCache::CloseDisk() noexcept
+{
+	if (m_diskFile) std::fclose(m_diskFile);
+	m_diskFile = nullptr;
+}
+
+bool MeshCache::ReadDisk(Key key, Entry &entry) noexcept
+{
+	const auto found = m_diskEntries.find(key);
+	if (found == m_diskEntries.end()) return false;
+
+	std::uint8_t entryHeader[entryHeaderSize];
+	std::fseek(m_diskFile, static_cast<long>(found->second), SEEK_SET);
+	if (std::fread(entryHeader, std::size_t{ 1u }, entryHeaderSize, m_diskFile) != entryHeaderSize) return false;
+
+	// A different key means the position is out of date (e.g. the file was changed by another game)
+	Key storedKey;
+	std::memcpy(&storedKey, entryHeader, sizeof(Key));
+	if (storedKey != key) { m_diskEntries.erase(found); return false; }
+	std::memcpy(entry.faceCounts, entryHeader + sizeof(Key), sizeof(entry.faceCounts));
+
+	std::size_t totalFaces{};
+	for (const std::uint16_t (&counts)[2] : entry.faceCounts) totalFaces += static_cast<std::size_t>(counts[0]) + static_cast<std::size_t>(counts[1]);
+	entry.faces.resize(totalFaces);
+	if (std::fread(entry.faces.data(), sizeof(std::uint32_t), totalFaces, m_diskFile) != totalFaces) return false;
+	entry.onDisk = true;
+	return true;
+}
+
+void MeshCache::WriteDisk(Key key, const Entry &entry) noexcept
+{
+	// The file is started again once it is too large (the oldest meshes are likely not needed anymore)
+	const std::size_t entrySize = entryHeaderSize + (entry.faces.size() * sizeof(std::uint32_t));
+	if (m_diskEntries.count(key)) return;
+	if (m_diskSize + entrySize > maxDiskSize && !OpenDisk(true)) return;
+
+	std::uint8_t entryHeader[entryHeaderSize];
+	std::memcpy(entryHeader, &key, sizeof(Key));
+	std::memcpy(entryHeader + sizeof(Key), entry.faceCounts, sizeof(entry.faceCounts));
+	std::fseek(m_diskFile, static_cast<long>(m_diskSize.load()), SEEK_SET);
+	if (std::fwrite(entryHeader, std::size_t{ 1u }, entryHeaderSize, m_diskFile) != entryHeaderSize ||
+		std::fwrite(entry.faces.data(), sizeof(std::uint32_t), entry.faces.size(), m_diskFile) != entry.faces.size()) return;
+
+	m_diskEntries[key] = static_cast<std::uint64_t>(m_diskSize.load());
+	m_diskSize += entrySize;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef _SOURCE_WORLD_MESHCACHE_HDR_
+#define _SOURCE_WORLD_MESHCACHE_HDR_
+
+#include "Chunk.hpp"
+#include <atomic>
+
+// Face data of calculated chunks found by a hash of the chunk's blocks and the blocks on the borders of its neighbours,
+// so chunks that are loaded again with the same blocks (e.g. returning to an area) don't need their faces calculated.
+// The least recently used meshes are removed once the cache is over its memory limit, and can be added to a file first
+// (disk tier) which is kept between games and checked when a mesh is not in memory. Chunks are calculated on multiple
+// threads so everything is locked.
+class MeshCache
+{
+public:
+	typedef std::uint64_t Key;
+
+	MeshCache() noexcept {}
+	MeshCache(const MeshCache&) = delete;
+	MeshCache &operator=(const MeshCache&) = delete;
+	~MeshCache(); // Meshes in memory are added to the disk tier
+
+	// Blocks of the chunk and its neighbours must not be compressed (same as calculating the chunk)
+	static Key ChunkKey(const Chunk &chunk) noexcept;
+
+	// Gives the chunk the cached face data if found (counts as calculated), otherwise adds its newly calculated faces
+	bool Find(Key key, Chunk &chunk) noexcept;
+	void Add(Key key, const Chunk &chunk) noexcept;
+
+	// Meshes removed from memory are added to the file at the given path (empty to only keep them in memory)
+	void SetDiskPath(const std::string &path) noexcept;
+	void Clear() noexcept;
+
+	double HitRate() const noexcept;
+	std::size_t Count() noexcept;
+	std::size_t MemorySize() const noexcept { return m_memorySize.load(); }
+	std::size_t DiskSize() const noexcept { return m_diskSize.load(); }
+	bool HasDisk() const noexcept { return m_diskFile != nullptr; }
+
+	std::atomic<std::size_t> memoryLimit{ 32u << 20u }; // Bytes (0 to disable the cache)
+	static constexpr std::size_t maxDiskSize = 256u << 20u; // File is started again once larger
+	std::atomic<std::uintmax_t> hits{}, diskHits{}, misses{};
+private:
+	struct Entry {
+		std::uint16_t faceCounts[6][2]; // Opaque and translucent faces in each direction
+		std::vector<std::uint32_t> faces;
+		Entry *older, *newer; // Order of use (linked once in the map, as entries do not move)
+		Key key;
+		bool onDisk;
+	};
+	static constexpr std::size_t entryHeaderSize = sizeof(Key) + sizeof(Entry::faceCounts);
+
+	static std::size_t EntrySize(const Entry &entry) noexcept { return sizeof(Entry) + (entry.faces.capacity() * sizeof(std::uint32_t)); }
+	static void GiveFaces(const Entry &entry, Chunk &chunk) noexcept;
+	void Unlink(Entry &entry) noexcept;
+	void LinkNewest(Entry &entry) noexcept;
+	void RemoveOldest() noexcept;
+
+	// Disk tier (locked)
+	bool OpenDisk(bool replace) noexcept;
+	void CloseDisk() noexcept;
+	bool ReadDisk(Key key, Entry &entry) noexcept;
+	void WriteDisk(Key key, const Entry &entry) noexcept;
+
+	std::unordered_map<Key, Entry> m_entries;
+	std::unordered_map<Key, std::uint64_t> m_diskEntries; // Position of each mesh in the file
+	Entry *m_oldest = nullptr, *m_newest = nullptr;
+	std::atomic<std::size_t> m_memorySize{}, m_diskSize{};
+	std::string m_diskPath;
+	std::FILE *m_diskFile = nullptr;
+	std::mutex m_mutex;
+};
+
+#endif // _SOURCE_WORLD_MESHCACHE_HDR_
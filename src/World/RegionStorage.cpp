@@ -0,0 +1,605 @@
+#include "RegionStorage.hpp"
+
+namespace
+{
+	const char regionMagic[4] = { 'B', 'C', 'R', 'G' };
+	const std::uint32_t regionVersion = 2u; // Version 1 files (without uncompressed chunks) can still be read
+
+	// Each chunk in a column starts with how its blocks are stored
+	enum ChunkFormat : std::uint8_t { CF_Air, CF_RunLength, CF_Raw };
+
+	// Each column has its data position, size of its encoded blocks and number of pending changes
+	const std::size_t tableEntrySize = sizeof(std::uint32_t) * 3u;
+	const std::size_t headerSize = sizeof(regionMagic) + sizeof(std::uint32_t) + (tableEntrySize * static_cast<std::size_t>(RegionStorage::regionColumns));
+
+	void WriteU32(std::uint8_t *data, std::uint32_t value) noexcept { std::memcpy(data, &value, sizeof(std::uint32_t)); }
+	std::uint32_t ReadU32(const std::uint8_t *data) noexcept { std::uint32_t value; std::memcpy(&value, data, sizeof(std::uint32_t)); return value; }
+}
+
+RegionStorage::RegionStorage() noexcept
+{
+	m_thread = std::thread(&RegionStorage::IOLoop, this);
+}
+
+RegionStorage::~RegionStorage()
+{
+	// Any queued requests (e.g. saving all loaded columns) are still completed
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_stopping = true;
+	}
+	m_requestCondition.notify_one();
+	m_thread.join();
+
+	for (Completion &completion : m_completions) delete completion.result.column;
+}
+
+void RegionStorage::SetDirectory(const std::string &directory, std::int64_t worldID) noexcept
+{
+	// Needs to be set before any requests are made
+	m_directory = directory;
+	m_worldID = worldID;
+	m_directoryCreated = false;
+	m_regionExists.clear();
+}
+
+RegionStorage::ColumnState RegionStorage::GetColumnState(const WorldXZPosition &offset) noexcept
+{
+	if (m_savedColumns.find(ColumnKey(offset)) != m_savedColumns.end()) return ColumnState::Saved;
+
+	// Check which columns are saved in the region the first time a column in it is needed
+	const WorldPosition region = RegionOffset(offset);
+	const auto found = m_regionStates.find(region);
+	if (found == m_regionStates.end()) {
+		m_regionStates[region] = RS_Indexing;
+		Submit(Request{ Request::RT_Index, region, offset, {}, {} });
+		return ColumnState::Unknown;
+	}
+	return found->second == RS_Indexed ? ColumnState::NotSaved : ColumnState::Unknown;
+}
+
+void RegionStorage::LoadColumn(const WorldXZPosition &offset, const LoadCallback &callback) noexcept
+{
+	const WorldPosition key = ColumnKey(offset);
+	if (m_loadCallbacks.find(key) != m_loadCallbacks.end()) return; // Already loading
+	m_loadCallbacks[key] = callback;
+	Submit(Request{ Request::RT_Load, RegionOffset(offset), offset, {}, {} });
+}
+
+void RegionStorage::SaveColumn(const ChunkColumn &column) noexcept
+{
+	std::vector<std::uint8_t> blocks;
+	EncodeColumn(column, blocks);
+	SaveColumn({ column.Offset().x, column.Offset().z }, std::move(blocks));
+}
+
+void RegionStorage::SaveColumn(const WorldXZPosition &offset, std::vector<std::uint8_t> &&blocks) noexcept
+{
+	SavedColumn saved;
+	saved.blocks = std::move(blocks);
+	m_queuedWrites[RegionOffset(offset)].emplace_back(QueuedWrite{ ColumnIndex(offset), std::move(saved), true });
+	m_savedColumns[ColumnKey(offset)] = true;
+	++columnsSaved;
+}
+
+void RegionStorage::SavePending(const WorldPosition &chunkOffset, const Chunk::BlockQueueVector &queue) noexcept
+{
+	// Natural changes (e.g. trees) are created again when nearby columns generate
+	if (chunkOffset.y < PosType{} || chunkOffset.y >= static_cast<PosType>(ChunkValues::heightCount)) return; // Outside of the world
+	SavedColumn saved;
+	const int columnY = static_cast<int>(chunkOffset.y) * ChunkValues::size;
+	for (const Chunk::BlockQueue &queued : queue) {
+		if (queued.natural) continue;
+		const SavedBlock block = { static_cast<std::uint8_t>(queued.pos.x), static_cast<std::uint8_t>(columnY + queued.pos.y), static_cast<std::uint8_t>(queued.pos.z), queued.blockID };
+		saved.pending.emplace_back(block);
+	}
+	if (saved.pending.empty()) return;
+
+	const WorldXZPosition offset = { chunkOffset.x, chunkOffset.z };
+	m_queuedWrites[RegionOffset(offset)].emplace_back(QueuedWrite{ ColumnIndex(offset), std::move(saved), false });
+	m_savedColumns[ColumnKey(offset)] = true;
+}
+
+void RegionStorage::Flush() noexcept
+{
+	for (auto &it : m_queuedWrites) Submit(Request{ Request::RT_Write, it.first, WorldXZPosition{}, std::move(it.second), {} });
+	m_queuedWrites.clear();
+}
+
+void RegionStorage::LogEdit(const WorldPosition &position, ObjectID oldBlock, ObjectID newBlock) noexcept
+{
+	if (position.y < PosType{} || position.y >= static_cast<PosType>(ChunkValues::maxHeight)) return; // Outside of the world
+	const EditLog::Edit edit = { position, oldBlock, newBlock };
+	m_loggedEdits.emplace_back(edit);
+}
+
+void RegionStorage::FlushEdits() noexcept
+{
+	if (m_loggedEdits.empty()) return;
+	m_logSize += m_loggedEdits.size() * EditLog::editSize;
+	Submit(Request{ Request::RT_Log, WorldPosition{}, WorldXZPosition{}, {}, std::move(m_loggedEdits) });
+	m_loggedEdits.clear();
+}
+
+void RegionStorage::CompactLog(std::vector<EditLog::Edit> &&keptEdits) noexcept
+{
+	// Any changes not logged yet are already in the saved columns (or kept)
+	m_loggedEdits.clear();
+	m_logSize = keptEdits.size() * EditLog::editSize;
+	Submit(Request{ Request::RT_Compact, WorldPosition{}, WorldXZPosition{}, {}, std::move(keptEdits) });
+}
+
+bool RegionStorage::ReadEditLog(std::vector<EditLog::Edit> &edits) const noexcept
+{
+	const std::string path = LogPath();
+	return FileManager::FileExists(path) && EditLog::Read(path, m_worldID, edits);
+}
+
+int RegionStorage::ProcessCompletions() noexcept
+{
+	std::vector<Completion> completions;
+	{
+		std::lock_guard<std::mutex> lock(m_completionMutex);
+		if (m_completions.empty()) return 0;
+		completions.swap(m_completions);
+	}
+
+	int count = 0;
+	for (Completion &completion : completions) {
+		++count;
+		if (completion.type == Request::RT_Index) {
+			m_regionStates[completion.region] = RS_Indexed;
+			for (const WorldXZPosition &offset : completion.savedOffsets) m_savedColumns[ColumnKey(offset)] = true;
+			continue;
+		}
+		if (completion.type == Request::RT_Write) {
+			// Failed write - changes are only in the edit log (applied again when the game next starts)
+			for (const WorldXZPosition &offset : completion.savedOffsets) m_savedColumns.erase(ColumnKey(offset));
+			continue;
+		}
+
+		const auto found = m_loadCallbacks.find(ColumnKey(completion.result.offset));
+		if (found != m_loadCallbacks.end()) {
+			const LoadCallback callback = std::move(found->second);
+			m_loadCallbacks.erase(found);
+			if (completion.result.column) ++columnsLoaded;
+			callback(completion.result);
+		}
+		delete completion.result.column; // Not taken by the callback
+	}
+
+	return count;
+}
+
+void RegionStorage::WaitIdle() noexcept
+{
+	std::unique_lock<std::mutex> lock(m_requestMutex);
+	m_idleCondition.wait(lock, [this]() { return m_requests.empty() && !m_busy; });
+}
+
+RegionStorage::ReadBenchmark RegionStorage::BenchmarkReads() noexcept
+{
+	// The I/O thread state is only used here whilst it is waiting for requests (which are only made by this thread)
+	WaitIdle();
+	ReadBenchmark result{};
+	std::vector<WorldPosition> regions;
+	for (const auto &it : m_regionStates) if (it.second == RS_Indexed && RegionExists(it.first)) regions.emplace_back(it.first);
+	result.regions = static_cast<int>(regions.size());
+
+	const auto loadAll = [&](bool mapped, bool cold) {
+		if (cold) for (const WorldPosition &region : regions) result.evicted = MappedFile::Evict(RegionPath(region));
+
+		const double start = glfwGetTime();
+		result.columns = std::size_t{};
+		for (const WorldPosition &region : regions) {
+			MappedFile file;
+			if (!OpenRegion(region, file, mapped)) continue;
+
+			ColumnData column;
+			for (int i = 0; i < regionColumns; ++i) {
+				if (!GetColumnData(file, i, column) || !column.blocksSize) continue;
+				const WorldXZPosition offset = {
+					(region.x * static_cast<PosType>(regionSize)) + static_cast<PosType>(i >> regionBits),
+					(region.z * static_cast<PosType>(regionSize)) + static_cast<PosType>(i & (regionSize - 1))
+				};
+				delete CreateColumn(offset, column.blocks, column.blocksSize);
+				++result.columns;
+			}
+		}
+		return (glfwGetTime() - start) * 1000.0;
+	};
+
+	result.coldBufferedMs = loadAll(false, true);
+	result.warmBufferedMs = loadAll(false, false);
+	result.coldMappedMs = loadAll(true, true);
+	result.warmMappedMs = loadAll(true, false);
+	return result;
+}
+
+void RegionStorage::Submit(Request &&request) noexcept
+{
+	++m_queueDepth;
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requests.emplace_back(std::move(request));
+	}
+	m_requestCondition.notify_one();
+}
+
+void RegionStorage::IOLoop() noexcept
+{
+	for (;;) {
+		// Take all waiting requests at once so requests for the same region can be combined
+		std::deque<Request> requests;
+		{
+			std::unique_lock<std::mutex> lock(m_requestMutex);
+			m_busy = false;
+			m_idleCondition.notify_all();
+			m_requestCondition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+			if (m_requests.empty()) return; // Stopping with nothing left to do
+			requests.swap(m_requests);
+			m_busy = true;
+		}
+
+		ProcessRequests(requests);
+	}
+}
+
+void RegionStorage::ProcessRequests(std::deque<Request> &requests) noexcept
+{
+	// Writes are done first (all changes to a region in one write) so reads in the same batch include them
+	FlatPositionMap<std::vector<QueuedWrite>> writes;
+	FlatPositionMap<std::vector<const Request*>> reads;
+	for (Request &request : requests) {
+		if (request.type == Request::RT_Load || request.type == Request::RT_Index) { reads[request.region].emplace_back(&request); continue; }
+		if (request.type != Request::RT_Write) continue;
+		std::vector<QueuedWrite> &regionWrites = writes[request.region];
+		regionWrites.insert(regionWrites.end(), std::make_move_iterator(request.writes.begin()), std::make_move_iterator(request.writes.end()));
+	}
+
+	std::vector<Completion> completions;
+	for (auto &it : writes) {
+		// Keep any other columns already in the file
+		Region columns(static_cast<std::size_t>(regionColumns));
+		bool written = !RegionExists(it.first) || ReadRegion(it.first, columns); // Don't overwrite an unreadable file
+		std::vector<bool> wasSaved(static_cast<std::size_t>(regionColumns));
+		for (int i = 0; i < regionColumns; ++i) wasSaved[static_cast<std::size_t>(i)] = written && (!columns[static_cast<std::size_t>(i)].blocks.empty() || !columns[static_cast<std::size_t>(i)].pending.empty());
+
+		if (written) {
+			for (QueuedWrite &write : it.second) {
+				SavedColumn &column = columns[static_cast<std::size_t>(write.index)];
+				if (write.replaceBlocks) column = std::move(write.column); // Saved blocks already include any pending changes
+				else column.pending.insert(column.pending.end(), write.column.pending.begin(), write.column.pending.end());
+			}
+			written = WriteRegion(it.first, columns);
+		}
+		if (written) { m_regionExists[it.first] = true; continue; }
+
+		// Columns that were not already in the file are no longer known to be saved
+		m_writeFailed = true;
+		Completion completion;
+		completion.type = Request::RT_Write;
+		completion.region = it.first;
+		completion.result.column = nullptr;
+		for (const QueuedWrite &write : it.second) {
+			if (wasSaved[static_cast<std::size_t>(write.index)]) continue;
+			completion.savedOffsets.emplace_back(WorldXZPosition(
+				(it.first.x * static_cast<PosType>(regionSize)) + static_cast<PosType>(write.index >> regionBits),
+				(it.first.z * static_cast<PosType>(regionSize)) + static_cast<PosType>(write.index & (regionSize - 1))
+			));
+		}
+		completions.emplace_back(std::move(completion));
+	}
+
+	// Logged changes are written in order, with a compaction replacing everything logged before it. Columns saved
+	// before a compaction have already been written (and synced) above so none of the removed changes are lost.
+	// Once any region could not be written its changes are only in the log, so the kept changes are added instead.
+	std::vector<EditLog::Edit> loggedEdits;
+	bool compact = false;
+	for (const Request &request : requests) {
+		if (request.type == Request::RT_Compact && !m_writeFailed) { compact = true; loggedEdits.clear(); }
+		if (request.type == Request::RT_Log || request.type == Request::RT_Compact) loggedEdits.insert(loggedEdits.end(), request.edits.begin(), request.edits.end());
+	}
+	if (compact || !loggedEdits.empty()) WriteLog(compact, loggedEdits);
+
+	// Each region is only opened once for all of the loads in it, with columns decoded straight from the file data
+	for (const auto &it : reads) {
+		MappedFile file;
+		const bool exists = RegionExists(it.first) && OpenRegion(it.first, file, mappedReads);
+
+		for (const Request *request : it.second) {
+			Completion completion;
+			completion.type = request->type;
+			completion.region = it.first;
+			completion.result.offset = request->offset;
+			completion.result.column = nullptr;
+
+			ColumnData column;
+			if (exists && request->type == Request::RT_Index) {
+				for (int i = 0; i < regionColumns; ++i) {
+					if (!GetColumnData(file, i, column)) continue;
+					completion.savedOffsets.emplace_back(WorldXZPosition(
+						(it.first.x * static_cast<PosType>(regionSize)) + static_cast<PosType>(i >> regionBits), 
+						(it.first.z * static_cast<PosType>(regionSize)) + static_cast<PosType>(i & (regionSize - 1))
+					));
+				}
+			}
+			else if (exists && GetColumnData(file, ColumnIndex(request->offset), column)) {
+				if (column.blocksSize) completion.result.column = CreateColumn(request->offset, column.blocks, column.blocksSize);
+				completion.result.pending.resize(column.pendingCount);
+				if (column.pendingCount) std::memcpy(completion.result.pending.data(), column.pending, column.pendingCount * sizeof(SavedBlock));
+				if (file.IsMapped()) m_bytesTransferred += static_cast<std::uintmax_t>(column.blocksSize + (column.pendingCount * sizeof(SavedBlock)));
+			}
+
+			completions.emplace_back(std::move(completion));
+		}
+	}
+
+	if (!completions.empty()) {
+		std::lock_guard<std::mutex> lock(m_completionMutex);
+		m_completions.insert(m_completions.end(), std::make_move_iterator(completions.begin()), std::make_move_iterator(completions.end()));
+	}
+	m_queueDepth -= requests.size();
+}
+
+void RegionStorage::EncodeColumn(const ChunkColumn &column, std::vector<std::uint8_t> &result)
+{
+	// Blocks of each chunk, with air chunks only using 1 byte. Chunks that don't compress well (e.g. varied terrain or 
+	// builds) are stored as they are in memory instead, so they can be copied straight from a mapped region file.
+	// Compressed chunks are decompressed into a separate array so the column is not changed.
+	ChunkValues::BlockArray *decompressed = nullptr;
+	for (const Chunk &chunk : column.chunks) {
+		if (chunk.IsAir()) { result.emplace_back(CF_Air); continue; }
+		if (!chunk.chunkBlocks && !decompressed) decompressed = new ChunkValues::BlockArray;
+		if (!chunk.chunkBlocks) chunk.CopyBlocks(*decompressed);
+		const ChunkValues::BlockArray &chunkBlocks = chunk.chunkBlocks ? *chunk.chunkBlocks : *decompressed;
+
+		const std::size_t start = result.size();
+		result.emplace_back(CF_RunLength);
+		EncodeBlocks(chunkBlocks, result);
+		if (result.size() - start <= sizeof(ChunkValues::BlockArray)) continue;
+
+		const std::uint8_t *blocks = reinterpret_cast<const std::uint8_t*>(chunkBlocks.blocks);
+		result.resize(start);
+		result.emplace_back(CF_Raw);
+		result.insert(result.end(), blocks, blocks + sizeof(ChunkValues::BlockArray));
+	}
+	delete decompressed;
+}
+
+ChunkColumn *RegionStorage::CreateColumn(const WorldXZPosition &offset, const std::uint8_t *data, std::size_t size) noexcept
+{
+	// Decode all chunks first so nothing is created if the data is invalid (generated instead)
+	ChunkValues::BlockArray *arrays[ChunkValues::heightCount]{};
+	std::size_t position{};
+	bool valid = true;
+
+	for (int chunkY = 0; chunkY < ChunkValues::heightCount && valid; ++chunkY) {
+		if (position >= size) { valid = false; break; }
+		const std::uint8_t format = data[position++];
+		if (format == CF_Air) continue;
+
+		arrays[chunkY] = new ChunkValues::BlockArray;
+		if (format == CF_RunLength) { valid = DecodeBlocks(data, size, position, *arrays[chunkY]); continue; }
+		if (format != CF_Raw || size - position < sizeof(ChunkValues::BlockArray)) { valid = false; break; }
+
+		// Copied as it is, only checking that the blocks are valid
+		std::memcpy(arrays[chunkY]->blocks, data + position, sizeof(ChunkValues::BlockArray));
+		position += sizeof(ChunkValues::BlockArray);
+		const ObjectID *blocks = &arrays[chunkY]->blocks[0][0][0];
+		valid = std::all_of(blocks, blocks + ChunkValues::blocksAmount, [](ObjectID block) { return block < ObjectID::NumUnique; });
+	}
+
+	if (!valid) {
+		for (ChunkValues::BlockArray *blocks : arrays) delete blocks;
+		return nullptr;
+	}
+
+	ChunkColumn *column = new ChunkColumn(offset);
+	for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) {
+		Chunk &chunk = column->chunks[chunkY];
+		if (!arrays[chunkY]) continue;
+		chunk.chunkBlocks = Chunk::blockPool.enabled ? Chunk::blockPool.Share(arrays[chunkY]) : arrays[chunkY];
+		chunk.sharedBlocks = Chunk::blockPool.enabled;
+	}
+
+	for (int x = 0; x < ChunkValues::size; ++x) for (int z = 0; z < ChunkValues::size; ++z) column->UpdateHeight(x, z);
+	column->saved = true;
+	return column;
+}
+
+void RegionStorage::EncodeBlocks(const ChunkValues::BlockArray &blocks, std::vector<std::uint8_t> &result)
+{
+	// Runs of the same block (along Z first as the array is stored) as the block ID followed by the run length (7 bits per byte)
+	const ObjectID *data = &blocks.blocks[0][0][0];
+	for (int i = 0; i < ChunkValues::blocksAmount;) {
+		const ObjectID block = data[i];
+		int run = 1;
+		while (i + run < ChunkValues::blocksAmount && data[i + run] == block) ++run;
+		i += run;
+
+		result.emplace_back(static_cast<std::uint8_t>(block));
+		for (; run >= 0x80; run >>= 7) result.emplace_back(static_cast<std::uint8_t>((run & 0x7F) | 0x80));
+		result.emplace_back(static_cast<std::uint8_t>(run));
+	}
+}
+
+bool RegionStorage::DecodeBlocks(const std::uint8_t *data, std::size_t size, std::size_t &position, ChunkValues::BlockArray &blocks) noexcept
+{
+	ObjectID *result = &blocks.blocks[0][0][0];
+	for (int i = 0; i < ChunkValues::blocksAmount;) {
+		if (position >= size) return false;
+		const ObjectID block = static_cast<ObjectID>(data[position++]);
+		if (block >= ObjectID::NumUnique) return false;
+
+		int run = 0;
+		for (int shift = 0;; shift += 7) {
+			if (position >= size || shift > 21) return false;
+			const std::uint8_t byte = data[position++];
+			run |= (byte & 0x7F) << shift;
+			if (!(byte & 0x80)) break;
+		}
+		if (!run || run > ChunkValues::blocksAmount - i) return false;
+
+		std::fill_n(result + i, run, block);
+		i += run;
+	}
+	return true;
+}
+
+WorldPosition RegionStorage::RegionOffset(const WorldXZPosition &columnOffset) noexcept
+{
+	// Arithmetic shift rounds towards negative infinity, so negative offsets are in the correct region
+	return { columnOffset.x >> regionBits, PosType{}, columnOffset.y >> regionBits };
+}
+
+int RegionStorage::ColumnIndex(const WorldXZPosition &columnOffset) noexcept
+{
+	const PosType mask = static_cast<PosType>(regionSize - 1);
+	return static_cast<int>(((columnOffset.x & mask) << regionBits) | (columnOffset.y & mask));
+}
+
+std::string RegionStorage::RegionPath(const WorldPosition &region) const
+{
+	return fmt::format("{}/r.{}.{}.dat", m_directory, region.x, region.z);
+}
+
+std::string RegionStorage::LogPath() const
+{
+	return m_directory + "/edits.log";
+}
+
+bool RegionStorage::CreateSaveDirectory() noexcept
+{
+	// Create the save directory (and any parent directories) the first time anything is written
+	if (m_directoryCreated) return true;
+	try {
+		for (std::size_t end = m_directory.find('/'); ; end = m_directory.find('/', end + 1u)) {
+			const std::string directory = m_directory.substr(std::size_t{}, end);
+			if (!directory.empty() && !FileManager::DirectoryExists(directory)) FileManager::CreatePath(directory);
+			if (end == std::string::npos) break;
+		}
+	} catch (const FileManager::FileError &error) {
+		TextFormat::warn(error.what(), "Region write error");
+		return false;
+	}
+	m_directoryCreated = true;
+	return true;
+}
+
+bool RegionStorage::RegionExists(const WorldPosition &region) noexcept
+{
+	// Only check for the file once, all region files are written by this thread
+	const auto found = m_regionExists.find(region);
+	if (found != m_regionExists.end()) return found->second;
+	const bool exists = FileManager::FileExists(RegionPath(region));
+	m_regionExists[region] = exists;
+	return exists;
+}
+
+bool RegionStorage::OpenRegion(const WorldPosition &region, MappedFile &file, bool mapped) noexcept
+{
+	const std::string path = RegionPath(region);
+	if (!file.Open(path, mapped)) { TextFormat::warn(fmt::format("Failed to open region file '{}'", path), "Region read error"); return false; }
+
+	// Only the table is read straight away from mapped files
+	m_bytesTransferred += static_cast<std::uintmax_t>(file.IsMapped() ? glm::min(file.Size(), headerSize) : file.Size());
+	++regionReads;
+
+	const std::uint32_t version = file.Size() >= headerSize ? ReadU32(file.Data() + sizeof(regionMagic)) : 0u;
+	if (file.Size() < headerSize || std::memcmp(file.Data(), regionMagic, sizeof(regionMagic)) || !version || version > regionVersion) {
+		TextFormat::warn(fmt::format("Region file '{}' is invalid", path), "Region read error");
+		return false;
+	}
+	return true;
+}
+
+bool RegionStorage::GetColumnData(const MappedFile &file, int index, ColumnData &result) noexcept
+{
+	const std::uint8_t *data = file.Data(), *table = data + sizeof(regionMagic) + sizeof(std::uint32_t) + (tableEntrySize * static_cast<std::size_t>(index));
+	const std::size_t position = ReadU32(table), blocksSize = ReadU32(table + 4u), pendingCount = ReadU32(table + 8u);
+	if (!position) return false; // Column not saved
+	if (position < headerSize || position + blocksSize + (pendingCount * sizeof(SavedBlock)) > file.Size()) {
+		TextFormat::warn(fmt::format("Region file has an invalid column at index {}", index), "Region read error");
+		return false;
+	}
+
+	result = { data + position, blocksSize, data + position + blocksSize, pendingCount };
+	return true;
+}
+
+bool RegionStorage::ReadRegion(const WorldPosition &region, Region &result) noexcept
+{
+	// Copies all columns as the file gets replaced
+	MappedFile file;
+	if (!OpenRegion(region, file, false)) return false;
+
+	ColumnData data;
+	for (int i = 0; i < regionColumns; ++i) {
+		if (!GetColumnData(file, i, data)) continue;
+		SavedColumn &column = result[static_cast<std::size_t>(i)];
+		column.blocks.assign(data.blocks, data.blocks + data.blocksSize);
+		column.pending.resize(data.pendingCount);
+		if (data.pendingCount) std::memcpy(column.pending.data(), data.pending, data.pendingCount * sizeof(SavedBlock));
+	}
+
+	return true;
+}
+
+bool RegionStorage::WriteRegion(const WorldPosition &region, const Region &columns) noexcept
+{
+	if (!CreateSaveDirectory()) return false;
+
+	// Build the entire file first so it is written at once
+	std::vector<std::uint8_t> data(headerSize);
+	std::memcpy(data.data(), regionMagic, sizeof(regionMagic));
+	WriteU32(data.data() + sizeof(regionMagic), regionVersion);
+
+	for (int i = 0; i < regionColumns; ++i) {
+		const SavedColumn &column = columns[static_cast<std::size_t>(i)];
+		if (column.blocks.empty() && column.pending.empty()) continue;
+
+		const std::size_t position = data.size(), tableIndex = sizeof(regionMagic) + sizeof(std::uint32_t) + (tableEntrySize * static_cast<std::size_t>(i));
+		WriteU32(data.data() + tableIndex, static_cast<std::uint32_t>(position));
+		WriteU32(data.data() + tableIndex + 4u, static_cast<std::uint32_t>(column.blocks.size()));
+		WriteU32(data.data() + tableIndex + 8u, static_cast<std::uint32_t>(column.pending.size()));
+
+		data.insert(data.end(), column.blocks.begin(), column.blocks.end());
+		const std::uint8_t *pending = reinterpret_cast<const std::uint8_t*>(column.pending.data());
+		data.insert(data.end(), pending, pending + (column.pending.size() * sizeof(SavedBlock)));
+	}
+
+	// Write to a temporary file first so the previous file is kept if writing fails
+	const std::string path = RegionPath(region), tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file.good()) { TextFormat::warn(fmt::format("Failed to write region file '{}'", tempPath), "Region write error"); return false; }
+	}
+	EditLog::SyncFile(tempPath); // Needs to be on the disk before logged changes in it are removed
+
+	std::remove(path.c_str()); // Renaming does not replace existing files on Windows
+	if (std::rename(tempPath.c_str(), path.c_str())) {
+		TextFormat::warn(fmt::format("Failed to replace region file '{}'", path), "Region write error");
+		return false;
+	}
+
+	m_bytesTransferred += static_cast<std::uintmax_t>(data.size());
+	++regionWrites;
+	return true;
+}
+
+bool RegionStorage::WriteLog(bool replace, const std::vector<EditLog::Edit> &edits) noexcept
+{
+	// All changes are synced at once
+	if (!CreateSaveDirectory()) return false;
+	const std::string path = LogPath();
+	if (!m_editLog.Open(path, m_worldID, replace, edits) || (!replace && !m_editLog.Append(edits)) || !m_editLog.Sync()) {
+		TextFormat::warn(fmt::format("Failed to write edit log '{}'", path), "Edit log write error");
+		m_editLog.Close();
+		return false;
+	}
+
+	m_bytesTransferred += static_cast<std::uintmax_t>(edits.size() * EditLog::editSize);
+	return true;
+}
@@ -0,0 +1,181 @@
+#pragma once
+#ifndef _SOURCE_WORLD_REGIONSTORAGE_HDR_
+#define _SOURCE_WORLD_REGIONSTORAGE_HDR_
+
+#include "Chunk.hpp"
+#include "MappedFile.hpp"
+#include "EditLog.hpp"
+#include <condition_variable>
+#include <atomic>
+
+// Saves changed columns to region files (32x32 columns each) so they can be loaded instead of generated again.
+// Each file starts with a table containing the position and size of every saved column, followed by the columns
+// with their blocks run-length encoded (or uncompressed if that is smaller). Region files are memory-mapped for loading
+// so columns are decoded straight from the page cache without reading the whole file. Block changes are also added
+// to an edit log as they happen and removed from it once the changed columns are saved. All file access is done on a
+// separate I/O thread: requests are queued by the world thread, and results are given back to it through callbacks when
+// it processes completed requests.
+class RegionStorage
+{
+public:
+	static constexpr int regionBits = 5;
+	static constexpr int regionSize = 1 << regionBits;
+	static constexpr int regionColumns = regionSize * regionSize;
+
+	// Block change for a column that is not loaded (Y position is in the column)
+	struct SavedBlock {
+		std::uint8_t x, y, z;
+		ObjectID blockID;
+	};
+	static_assert(sizeof(SavedBlock) == 4u && ChunkValues::maxHeight <= 256, "Saved blocks are stored as 4 bytes with the Y position in 1 byte.");
+
+	// Saved blocks of a column (empty if never saved) and any changes to apply once it is loaded
+	struct SavedColumn {
+		std::vector<std::uint8_t> blocks;
+		std::vector<SavedBlock> pending;
+	};
+
+	// Result of loading a column - the callback takes ownership of the column (nullptr if it needs generating)
+	struct LoadResult {
+		WorldXZPosition offset;
+		ChunkColumn *column;
+		std::vector<SavedBlock> pending;
+	};
+	typedef std::function<void(LoadResult&)> LoadCallback;
+
+	enum class ColumnState : std::uint8_t { NotSaved, Saved, Unknown };
+
+	RegionStorage() noexcept;
+	RegionStorage(const RegionStorage&) = delete;
+	RegionStorage &operator=(const RegionStorage&) = delete;
+	~RegionStorage(); // Finishes all queued requests first
+
+	void SetDirectory(const std::string &directory, std::int64_t worldID) noexcept; // World ID is kept in the edit log
+
+	// World thread only - Unknown means the region has not been checked yet (requested if needed)
+	ColumnState GetColumnState(const WorldXZPosition &offset) noexcept;
+	void LoadColumn(const WorldXZPosition &offset, const LoadCallback &callback) noexcept;
+
+	// Save changes (written in the next flush, with all changes to the same region written together)
+	void SaveColumn(const ChunkColumn &column) noexcept;
+	void SaveColumn(const WorldXZPosition &offset, std::vector<std::uint8_t> &&blocks) noexcept; // Already encoded
+	void SavePending(const WorldPosition &chunkOffset, const Chunk::BlockQueueVector &queue) noexcept;
+	void Flush() noexcept;
+
+	// Block changes are logged (written together in the next edit flush) until the changed columns are saved and the log is 
+	// compacted, keeping only the given changes (e.g. to unloaded chunks). The log is read before any requests are made.
+	void LogEdit(const WorldPosition &position, ObjectID oldBlock, ObjectID newBlock) noexcept;
+	void FlushEdits() noexcept;
+	void CompactLog(std::vector<EditLog::Edit> &&keptEdits) noexcept;
+	bool ReadEditLog(std::vector<EditLog::Edit> &edits) const noexcept;
+	std::size_t LogSize() const noexcept { return m_logSize; } // Bytes logged since the last compaction
+	static constexpr std::size_t maxLogSize = 4u << 20u; // Compacted once larger
+
+	// Run callbacks of finished requests, returning the number of columns and regions that were loaded
+	int ProcessCompletions() noexcept;
+	void WaitIdle() noexcept;
+
+	// Encoded blocks of a whole column, and creating a column from them (nullptr if the data is invalid)
+	static void EncodeColumn(const ChunkColumn &column, std::vector<std::uint8_t> &result);
+	static ChunkColumn *CreateColumn(const WorldXZPosition &offset, const std::uint8_t *data, std::size_t size) noexcept;
+	static void EncodeBlocks(const ChunkValues::BlockArray &blocks, std::vector<std::uint8_t> &result);
+	static bool DecodeBlocks(const std::uint8_t *data, std::size_t size, std::size_t &position, ChunkValues::BlockArray &blocks) noexcept;
+
+	// Times loading every saved column in checked regions with buffered and mapped reads, both with the files
+	// removed from the page cache first (if supported) and again once cached. Waits for the I/O thread to be idle.
+	struct ReadBenchmark {
+		int regions;
+		std::size_t columns;
+		double coldBufferedMs, warmBufferedMs, coldMappedMs, warmMappedMs;
+		bool evicted; // Otherwise cold times may also be using the page cache
+	};
+	ReadBenchmark BenchmarkReads() noexcept;
+
+	std::size_t QueueDepth() const noexcept { return m_queueDepth.load(); } // Requests not yet completed
+	std::uintmax_t BytesTransferred() const noexcept { return m_bytesTransferred.load(); } // Total read and written
+
+	std::uintmax_t columnsSaved{}, columnsLoaded{};
+	std::atomic<std::uintmax_t> regionReads{}, regionWrites{};
+	std::atomic<bool> mappedReads{ true }; // Otherwise region files are read into a buffer for loading
+private:
+	struct QueuedWrite {
+		int index; // Column index in the region
+		SavedColumn column;
+		bool replaceBlocks; // Otherwise only adds pending changes
+	};
+
+	struct Request {
+		enum Type : std::uint8_t { RT_Write, RT_Load, RT_Index, RT_Log, RT_Compact };
+		Type type;
+		WorldPosition region;
+		WorldXZPosition offset; // Loaded column
+		std::vector<QueuedWrite> writes;
+		std::vector<EditLog::Edit> edits; // Logged (or kept when compacting)
+	};
+
+	struct Completion {
+		Request::Type type;
+		WorldPosition region;
+		std::vector<WorldXZPosition> savedOffsets; // Columns saved in an indexed region (or not saved after a failed write)
+		LoadResult result;
+	};
+
+	enum RegionState : std::uint8_t { RS_Indexing, RS_Indexed };
+
+	typedef std::vector<SavedColumn> Region;
+
+	// Position of a saved column within a region file
+	struct ColumnData {
+		const std::uint8_t *blocks;
+		std::size_t blocksSize;
+		const std::uint8_t *pending;
+		std::size_t pendingCount;
+	};
+
+	static WorldPosition RegionOffset(const WorldXZPosition &columnOffset) noexcept;
+	static WorldPosition ColumnKey(const WorldXZPosition &columnOffset) noexcept { return { columnOffset.x, PosType{}, columnOffset.y }; }
+	static int ColumnIndex(const WorldXZPosition &columnOffset) noexcept;
+
+	void Submit(Request &&request) noexcept;
+	void IOLoop() noexcept;
+	void ProcessRequests(std::deque<Request> &requests) noexcept;
+
+	// I/O thread only
+	std::string RegionPath(const WorldPosition &region) const;
+	std::string LogPath() const;
+	bool CreateSaveDirectory() noexcept;
+	bool RegionExists(const WorldPosition &region) noexcept;
+	bool OpenRegion(const WorldPosition &region, MappedFile &file, bool mapped) noexcept;
+	static bool GetColumnData(const MappedFile &file, int index, ColumnData &result) noexcept;
+	bool ReadRegion(const WorldPosition &region, Region &result) noexcept;
+	bool WriteRegion(const WorldPosition &region, const Region &columns) noexcept;
+	bool WriteLog(bool replace, const std::vector<EditLog::Edit> &edits) noexcept;
+
+	// World thread
+	FlatPositionMap<std::vector<QueuedWrite>> m_queuedWrites; // Changes waiting for the next flush in each region
+	FlatPositionMap<RegionState> m_regionStates; // Regions that have been (or are being) checked for saved columns
+	FlatPositionMap<bool> m_savedColumns; // Columns known to be saved
+	FlatPositionMap<LoadCallback> m_loadCallbacks; // Columns being loaded
+	std::vector<EditLog::Edit> m_loggedEdits; // Waiting for the next edit flush
+	std::size_t m_logSize{};
+
+	// I/O thread
+	FlatPositionMap<bool> m_regionExists; // Cached results of checking for region files
+	EditLog m_editLog;
+	bool m_directoryCreated = false;
+	bool m_writeFailed = false; // Changes in columns that could not be written are only in the log, so it is never compacted
+	std::string m_directory;
+	std::int64_t m_worldID{};
+
+	// Shared
+	std::deque<Request> m_requests;
+	std::vector<Completion> m_completions;
+	std::mutex m_requestMutex, m_completionMutex;
+	std::condition_variable m_requestCondition, m_idleCondition;
+	std::atomic<std::size_t> m_queueDepth{};
+	std::atomic<std::uintmax_t> m_bytesTransferred{};
+	bool m_stopping = false, m_busy = false;
+	std::thread m_thread;
+};
+
+#endif // _SOURCE_WORLD_REGIONSTORAGE_HDR_
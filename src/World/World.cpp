@@ -2,6 +2,22 @@
 
 World::World(WorldPlayer &player) noexcept : player(player)
 {
+	// Seeds are needed first so saved files are only used by the world they were made in
+	LoadSeeds();
+
+	// Changed columns are saved separately for each world seed
+	directory = fmt::format("Worlds/{}", game.noiseGenerators.elevation.seed);
+	regions.SetDirectory(directory, game.noiseGenerators.elevation.seed);
+
+	// Block changes that were not saved before the game last closed (e.g. from crashing) are applied again as chunks load
+	std::vector<EditLog::Edit> recoveredEdits;
+	if (regions.ReadEditLog(recoveredEdits) && !recoveredEdits.empty()) {
+		for (const EditLog::Edit &edit : recoveredEdits) {
+			m_blockQueue[ChunkValues::WorldToOffset(edit.position)].emplace_back(Chunk::BlockQueue(ChunkValues::WorldToLocal(edit.position), edit.newBlock, false));
+		}
+		TextFormat::log(fmt::format("Recovered {} block changes from the edit log", recoveredEdits.size()));
+	}
+
 	// VAO and VBO for debug chunk borders
 	m_bordersVAO = OGL::CreateVAO();
 	glEnableVertexAttribArray(0u);
@@ -74,11 +90,15 @@ World::World(WorldPlayer &player) noexcept : player(player)
 	// Buffer which holds the indexes into the world data for each 'instanced draw call' in indirect draw call
 	m_worldIBO = OGL::CreateBuffer(GL_DRAW_INDIRECT_BUFFER);
 
-	// TODO (possible): noise splines for more varied terrain generation
-	game.noiseGenerators = WorldNoise(nullptr);
-
 	// Initial update and buffer sizing
 	UpdateRenderDistance(chunkRenderDistance);
+
+	// Wait for saved columns around the spawn point so the world is complete before the player is placed
+	for (;;) {
+		regions.WaitIdle();
+		if (!regions.ProcessCompletions()) break;
+		OffsetUpdate();
+	}
 }
 
 void World::DrawWorld() const noexcept
@@ -114,7 +134,11 @@ void World::DebugChunkBorders(bool drawing) noexcept
 void World::DebugReset() noexcept
 {
 	// For debugging purposes - regenerate all nearby chunks
-	for (auto it = allchunks.cbegin(); it != allchunks.cend();) { delete it->second; allchunks.erase(it++); }
+	for (auto it = allcolumns.cbegin(); it != allcolumns.cend();) { RemoveColumn(it->second); allcolumns.erase(it++); }
+	for (auto it = m_evictedColumns.begin(); it != m_evictedColumns.end();) it = DropEvicted(it);
+	regions.Flush(); // Changed columns are loaded again instead of generated
+	m_deferredChunks.clear();
+	m_chunkGrid.Clear();
 	OffsetUpdate();
 }
 
@@ -127,111 +151,320 @@ Chunk *World::WorldPositionToChunk(const WorldPosition &pos) const noexcept
 ObjectID World::GetBlock(const WorldPosition &pos) const noexcept
  {
 	Chunk *chunk = WorldPositionToChunk(pos); // Get the chunk that contains the given position
-	if (chunk && chunk->chunkBlocks) return chunk->chunkBlocks->at(ChunkValues::WorldToLocal(pos)); // Returns the block at the local position in the chunk
+	const ChunkValues::BlockArray *blocks = chunk ? chunk->Blocks() : nullptr; // Decompressed first if needed
+	if (blocks) return blocks->at(ChunkValues::WorldToLocal(pos)); // Returns the block at the local position in the chunk
 	else return ObjectID::Air; // If no chunk is found, return an air block
 }
 
-void World::SetBlock(const WorldPosition &pos, ObjectID block, bool updateChunk) noexcept
+void World::GetBlocks(const WorldPosition *positions, ObjectID *blocks, std::size_t count) const noexcept
+{
+	// Small batches (e.g. collision checks) use stack memory and are grouped without allocating
+	constexpr std::size_t stackCount = 64u;
+	WorldPosition stackOffsets[stackCount];
+	glm::ivec3 stackLocalPositions[stackCount];
+	std::uint32_t stackOrder[stackCount];
+
+	const bool useStack = count <= stackCount;
+	WorldPosition *offsets = useStack ? stackOffsets : new WorldPosition[count];
+	glm::ivec3 *localPositions = useStack ? stackLocalPositions : new glm::ivec3[count];
+	std::uint32_t *order = useStack ? stackOrder : new std::uint32_t[count];
+
+	// Convert all positions and group them by chunk, so each chunk is only found once
+	ChunkValues::WorldToOffsetLocal(positions, count, offsets, localPositions);
+	ChunkValues::GroupByChunk(offsets, count, order);
+
+	const ChunkValues::BlockArray *chunkBlocks = nullptr;
+	for (std::size_t i{}; i < count; ++i) {
+		const std::uint32_t index = order[i];
+		if (!i || offsets[index] != offsets[order[i - 1u]]) {
+			Chunk *chunk = GetChunk(offsets[index]);
+			chunkBlocks = chunk ? chunk->Blocks() : nullptr;
+		}
+		blocks[index] = chunkBlocks ? chunkBlocks->at(localPositions[index]) : ObjectID::Air; // Air if there is no chunk
+	}
+
+	if (useStack) return;
+	delete[] offsets;
+	delete[] localPositions;
+	delete[] order;
+}
+
+void World::SetBlock(const WorldPosition &pos, ObjectID block) noexcept
 {
-	// Get chunk that contains the given position
+	// Get chunk that contains the given position and the local chunk position of the block
 	const WorldPosition offset = ChunkValues::WorldToOffset(pos);
-	Chunk *chunk = GetChunk(offset);
+	SetChunkBlock(GetChunk(offset), offset, ChunkValues::WorldToLocal(pos), block);
+	journal.EndAction();
+}
 
-	// Get local chunk position of the block
-	const glm::ivec3 localPos = ChunkValues::WorldToLocal(pos);
+void World::SetBlocks(const WorldPosition *positions, const ObjectID *blocks, std::size_t count) noexcept
+{
+	WorldPosition *offsets = new WorldPosition[count];
+	glm::ivec3 *localPositions = new glm::ivec3[count];
+	std::uint32_t *order = new std::uint32_t[count];
+
+	// Convert all positions and group them by chunk, so each chunk is only found once (changes are applied in order within each chunk)
+	ChunkValues::WorldToOffsetLocal(positions, count, offsets, localPositions);
+	ChunkValues::GroupByChunk(offsets, count, order);
+
+	Chunk *chunk = nullptr;
+	for (std::size_t i{}; i < count; ++i) {
+		const std::uint32_t index = order[i];
+		if (!i || offsets[index] != offsets[order[i - 1u]]) chunk = GetChunk(offsets[index]);
+		SetChunkBlock(chunk, offsets[index], localPositions[index], blocks[index]);
+	}
+	journal.EndAction();
 
+	delete[] offsets;
+	delete[] localPositions;
+	delete[] order;
+}
+
+void World::SetChunkBlock(Chunk *chunk, const WorldPosition &offset, const glm::ivec3 &localPos, ObjectID block) noexcept
+{
 	// Add to queue if the chunk does not exist, no need to check for bordering chunks
 	// as they will be updated later on when the chunk is created
+	const WorldPosition position = (offset * static_cast<PosType>(ChunkValues::size)) + WorldPosition(localPos);
 	if (!chunk) {
+		if (!saveEdits) return; // Temporary changes are only made to loaded chunks
 		m_blockQueue[offset].emplace_back(Chunk::BlockQueue(localPos, block, false));
+		regions.LogEdit(position, ObjectID::NumUnique, block);
 		return;
 	}
 
-	// If it exists, change the block and possibly update chunk + bordering chunks
-	if (!chunk->chunkBlocks) {
-		if (block == ObjectID::Air) return; // Ignore uneccessary changes (air to 'air chunk')
-		else chunk->AllocateChunkBlocks(); // Use normal block storage
-	}
-
-	chunk->chunkBlocks->atref(localPos) = block; // Change block at local position
+	// If it exists, change the block and mark the chunk + bordering chunks to be calculated in the next frame
+	const ChunkValues::BlockArray *chunkBlocks = chunk->Blocks();
+	const ObjectID currentBlock = chunkBlocks ? chunkBlocks->at(localPos) : ObjectID::Air;
+	if (currentBlock == block) return; // Nothing to update (including air in 'air chunks')
+	if (saveEdits) regions.LogEdit(position, currentBlock, block);
+	journal.Record(offset, localPos, currentBlock, block);
+	chunk->WritableBlocks()->atref(localPos) = block; // Change block at local position (allocated or copied first if needed)
+	chunk->modified |= saveEdits;
+	chunk->column->BlockChanged(localPos.x, (static_cast<int>(offset.y) * ChunkValues::size) + localPos.y, localPos.z, block == ObjectID::Air);
 
 	// Update bordering chunks if changed block was on a corner
 	NearbyChunkData nearbyData[6];
-	const int count = GetNearbyChunks(offset, nearbyData, true);
+	const int count = GetNearbyChunks(chunk, nearbyData, true);
 	for (int i = 0; i < count; ++i) {
 		const NearbyChunkData &nearby = nearbyData[i];
-		if (!ChunkValues::IsOnCorner(localPos, nearby.direction)) continue;
-		if (updateChunk) nearby.nearbyChunk->CalculateTerrainData(allchunks);
-		else nearby.nearbyChunk->gameState = Chunk::ChunkState::UpdateRequest;
+		if (ChunkValues::IsOnCorner(localPos, nearby.direction)) MarkChunkDirty(nearby.nearbyChunk);
 	}
-	
-	if (updateChunk) { chunk->CalculateTerrainData(allchunks); UpdateWorldBuffers(); }
-	else chunk->gameState = Chunk::ChunkState::UpdateRequest;
+	MarkChunkDirty(chunk);
 }
 
-std::uintmax_t World::FillBlocks(WorldPosition from, WorldPosition to, ObjectID objectID) noexcept
+World::BlockEditResult World::EditBlocks(BlockEdit edit) noexcept
 {
-	// Force valid position - ensure Y position is in range
-	from.y = glm::clamp(from.y, PosType{}, static_cast<PosType>(ChunkValues::maxHeight));
-	to.y = glm::clamp(to.y, PosType{}, static_cast<PosType>(ChunkValues::maxHeight));
+	BlockEditResult result{};
+
+	// Order the corners and ensure the Y positions are in range
+	for (int i = 0; i < 3; ++i) if (edit.from[i] > edit.to[i]) std::swap(edit.from[i], edit.to[i]);
+	edit.from.y = glm::max(edit.from.y, PosType{});
+	edit.to.y = glm::min(edit.to.y, static_cast<PosType>(ChunkValues::maxHeight - 1));
+	if (edit.from.y > edit.to.y) return result;
+
+	const WorldPosition offsetFrom = ChunkValues::WorldToOffset(edit.from), offsetTo = ChunkValues::WorldToOffset(edit.to);
+	const PosType chunkSize = static_cast<PosType>(ChunkValues::size), sizeLess = static_cast<PosType>(ChunkValues::sizeLess);
+
+	// Spheres and cylinders (vertical) fill the box between the corners - blocks are inside if their position is
+	const glm::dvec3 center = (glm::dvec3(edit.from) + glm::dvec3(edit.to)) * 0.5;
+	const glm::dvec3 radius = ((glm::dvec3(edit.to) - glm::dvec3(edit.from)) * 0.5) + glm::dvec3(0.5);
+
+	// Range of Z positions inside the shape at the given X and Y position (empty if the first is larger)
+	const auto ShapeSpanZ = [&](PosType x, PosType y, PosType &first, PosType &last) {
+		first = edit.from.z; last = edit.to.z;
+		if (edit.shape == BlockEdit::ES_Box) return;
+
+		const double nx = (static_cast<double>(x) - center.x) / radius.x, ny = (static_cast<double>(y) - center.y) / radius.y;
+		const double remaining = 1.0 - (nx * nx) - (edit.shape == BlockEdit::ES_Sphere ? ny * ny : 0.0);
+		if (remaining < 0.0) { last = first - static_cast<PosType>(1); return; }
 
-	// Determine direction to move in each axis
-	const WorldPosition step = {
-		static_cast<PosType>(from.x > to.x ? -1 : 1),
-		static_cast<PosType>(from.y > to.y ? -1 : 1),
-		static_cast<PosType>(from.z > to.z ? -1 : 1)
+		const double halfZ = radius.z * std::sqrt(remaining);
+		first = glm::max(first, static_cast<PosType>(std::ceil(center.z - halfZ)));
+		last = glm::min(last, static_cast<PosType>(std::floor(center.z + halfZ)));
 	};
-	
-	// Prevent extremely large changes
-	const std::uintmax_t totalSets = glm::abs(to.x - from.x) * glm::abs(to.y - from.y) * glm::abs(to.z - from.z);
-	if (totalSets > static_cast<std::uintmax_t>(32768)) return totalSets;
 
-	// Ensure a block is still placed if any value is equal
-	for (int i = 0; i < 3; ++i) {
-		PosType &toAxis = to[i];
-		if (toAxis == from[i]) toAxis += step[i];
+	// Blocks in unloaded chunks are added to the block queue, which is limited in size (loaded chunks are changed directly so there is no limit).
+	// Count them using the part of the box in each chunk first so nothing is changed if there are too many.
+	WorldPosition offset;
+	std::uintmax_t unloadedBlocks{};
+	for (offset.x = offsetFrom.x; offset.x <= offsetTo.x; ++offset.x) {
+		for (offset.z = offsetFrom.z; offset.z <= offsetTo.z; ++offset.z) {
+			if (edit.replaceOnly || GetColumn({ offset.x, offset.z })) continue; // Unknown blocks cannot be replaced
+			for (offset.y = offsetFrom.y; offset.y <= offsetTo.y; ++offset.y) {
+				std::uintmax_t volume = 1u;
+				for (int i = 0; i < 3; ++i) {
+					const PosType corner = offset[i] * chunkSize;
+					volume *= static_cast<std::uintmax_t>(glm::min(edit.to[i], corner + sizeLess) - glm::max(edit.from[i], corner) + static_cast<PosType>(1));
+				}
+				unloadedBlocks += volume;
+			}
+		}
+	}
+	if (unloadedBlocks > maxQueuedEdit) {
+		result.tooLarge = true;
+		result.queued = unloadedBlocks;
+		return result;
 	}
 
-	// Set all of the valid blocks from fx, fy, fz to tx, ty, tz (inclusive) as the given block ID
-	WorldPosition set{};
-	for (set.x = from.x; set.x != to.x; set.x += step.x) {
-		for (set.y = from.y; set.y != to.y; set.y += step.y) {
-			for (set.z = from.z; set.z != to.z; set.z += step.z) SetBlock(set, objectID, false);
+	// Change blocks chunk by chunk, with each row of blocks along the Z axis being next to each other in memory
+	for (offset.x = offsetFrom.x; offset.x <= offsetTo.x; ++offset.x) {
+		for (offset.z = offsetFrom.z; offset.z <= offsetTo.z; ++offset.z) {
+			ChunkColumn *column = GetColumn({ offset.x, offset.z });
+			const PosType cornerX = offset.x * chunkSize, cornerZ = offset.z * chunkSize;
+			const int startX = static_cast<int>(glm::max(edit.from.x - cornerX, PosType{})), endX = static_cast<int>(glm::min(edit.to.x - cornerX, sizeLess));
+			const int startZ = static_cast<int>(glm::max(edit.from.z - cornerZ, PosType{})), endZ = static_cast<int>(glm::min(edit.to.z - cornerZ, sizeLess));
+			bool columnChanged = false;
+
+			for (offset.y = offsetFrom.y; offset.y <= offsetTo.y; ++offset.y) {
+				const PosType cornerY = offset.y * chunkSize;
+				const int startY = static_cast<int>(glm::max(edit.from.y - cornerY, PosType{})), endY = static_cast<int>(glm::min(edit.to.y - cornerY, sizeLess));
+				Chunk *chunk = column ? &column->chunks[offset.y] : nullptr;
+				if (!chunk && edit.replaceOnly) continue;
+				if (chunk) chunk->Blocks(); // Compressed blocks are read directly below
+
+				std::uintmax_t chunkChanged{};
+				for (int x = startX; x <= endX; ++x) {
+					for (int y = startY; y <= endY; ++y) {
+						PosType first, last;
+						ShapeSpanZ(cornerX + static_cast<PosType>(x), cornerY + static_cast<PosType>(y), first, last);
+						const int spanStart = glm::max(startZ, static_cast<int>(glm::clamp(first - cornerZ, static_cast<PosType>(-1), chunkSize)));
+						const int spanEnd = glm::min(endZ, static_cast<int>(glm::clamp(last - cornerZ, static_cast<PosType>(-1), chunkSize)));
+						if (spanStart > spanEnd) continue;
+
+						// Queue blocks in unloaded chunks
+						if (!chunk) {
+							Chunk::BlockQueueVector &queue = m_blockQueue[offset];
+							for (int z = spanStart; z <= spanEnd; ++z) {
+								queue.emplace_back(Chunk::BlockQueue({ x, y, z }, edit.block, false));
+								regions.LogEdit({ cornerX + static_cast<PosType>(x), cornerY + static_cast<PosType>(y), cornerZ + static_cast<PosType>(z) }, ObjectID::NumUnique, edit.block);
+							}
+							result.queued += static_cast<std::uintmax_t>(spanEnd - spanStart + 1);
+							continue;
+						}
+
+						// Air and shared blocks are only allocated or copied once a block would actually change
+						ObjectID *span = chunk->chunkBlocks && !chunk->sharedBlocks ? &chunk->chunkBlocks->blocks[x][y][spanStart] : nullptr;
+						for (int i = 0, count = spanEnd - spanStart + 1; i < count; ++i) {
+							const ObjectID current = span ? span[i] : (chunk->chunkBlocks ? chunk->chunkBlocks->blocks[x][y][spanStart + i] : ObjectID::Air);
+							if (current == edit.block || (edit.replaceOnly && current != edit.replaceBlock)) continue;
+							if (!span) span = &chunk->WritableBlocks()->blocks[x][y][spanStart];
+							span[i] = edit.block;
+							regions.LogEdit({ cornerX + static_cast<PosType>(x), cornerY + static_cast<PosType>(y), cornerZ + static_cast<PosType>(spanStart + i) }, current, edit.block);
+							journal.Record(offset, { x, y, spanStart + i }, current, edit.block);
+							++chunkChanged;
+						}
+					}
+				}
+
+				if (!chunkChanged) continue;
+				result.changed += chunkChanged;
+				chunk->modified = true;
+				columnChanged = true;
+
+				// Neighbours only need calculating again if the edited area reaches the shared border (each chunk is only added once)
+				if (MarkChunkDirty(chunk)) ++result.chunks;
+				const int ranges[3][2] = { { startX, endX }, { startY, endY }, { startZ, endZ } };
+				for (int direction = 0; direction < 6; ++direction) {
+					const int (&range)[2] = ranges[direction >> 1]; // Right/left is X, up/down is Y, front/back is Z
+					const bool onBorder = (direction & 1) ? range[0] == 0 : range[1] == ChunkValues::sizeLess;
+					Chunk *nearbyChunk = chunk->nearbyChunks[direction];
+					if (onBorder && nearbyChunk && MarkChunkDirty(nearbyChunk)) ++result.chunks;
+				}
+			}
+
+			// Heights only need to be found again once per column
+			if (columnChanged) for (int x = startX; x <= endX; ++x) for (int z = startZ; z <= endZ; ++z) column->UpdateHeight(x, z);
 		}
 	}
 
-	// Update all affected chunks
-	for (const auto &it : m_blockQueue) ApplyQueue(it.second, it.first, true);
-	ApplyUpdateRequest();
-	UpdateWorldBuffers();
+	journal.EndAction();
+	return result;
+}
+
+World::BlockEditResult World::UndoEdit(bool redo) noexcept
+{
+	BlockEditResult result{};
+	const EditJournal::Action *action = redo ? journal.Redo() : journal.Undo();
+	if (!action) return result;
+
+	// Undoing goes through the changes in reverse order (in case a block was changed more than once)
+	const std::size_t diffCount = action->size();
+	for (std::size_t d{}; d < diffCount; ++d) {
+		const EditJournal::ChunkDiff &diff = (*action)[redo ? d : diffCount - d - 1u];
+		const WorldPosition corner = diff.offset * static_cast<PosType>(ChunkValues::size);
+		Chunk *chunk = GetChunk(diff.offset);
+		const ChunkValues::BlockArray *chunkBlocks = chunk ? chunk->Blocks() : nullptr;
+		ChunkValues::BlockArray *writableBlocks = nullptr; // Air and shared blocks are only allocated or copied once a block would change
+		glm::ivec3 lowest(ChunkValues::size), highest(-1);
+
+		const std::size_t runCount = diff.runs.size();
+		for (std::size_t r{}; r < runCount; ++r) {
+			const EditJournal::Run &run = diff.runs[redo ? r : runCount - r - 1u];
+			const ObjectID block = redo ? run.block : run.previous;
+			for (int i = 0; i < static_cast<int>(run.count); ++i) {
+				const glm::ivec3 localPos = EditJournal::IndexToLocal(static_cast<int>(run.start) + i);
+				const WorldPosition position = corner + WorldPosition(localPos);
+
+				// Queue blocks if the chunk has been unloaded since
+				if (!chunk) {
+					m_blockQueue[diff.offset].emplace_back(Chunk::BlockQueue(localPos, block, false));
+					regions.LogEdit(position, ObjectID::NumUnique, block);
+					++result.queued;
+					continue;
+				}
+
+				const ObjectID current = writableBlocks ? writableBlocks->at(localPos) : chunkBlocks ? chunkBlocks->at(localPos) : ObjectID::Air;
+				if (current == block) continue;
+				if (!writableBlocks) writableBlocks = chunk->WritableBlocks();
+				writableBlocks->atref(localPos) = block;
+				regions.LogEdit(position, current, block);
+				lowest = glm::min(lowest, localPos);
+				highest = glm::max(highest, localPos);
+				++result.changed;
+			}
+		}
 
-	return std::uintmax_t{};
+		if (highest.x < 0) continue;
+		chunk->modified = true;
+
+		// Neighbours only need calculating again if the changed blocks reach the shared border
+		if (MarkChunkDirty(chunk)) ++result.chunks;
+		for (int direction = 0; direction < 6; ++direction) {
+			const int axis = direction >> 1; // Right/left is X, up/down is Y, front/back is Z
+			const bool onBorder = (direction & 1) ? lowest[axis] == 0 : highest[axis] == ChunkValues::sizeLess;
+			Chunk *nearbyChunk = chunk->nearbyChunks[direction];
+			if (onBorder && nearbyChunk && MarkChunkDirty(nearbyChunk)) ++result.chunks;
+		}
+		for (int x = lowest.x; x <= highest.x; ++x) for (int z = lowest.z; z <= highest.z; ++z) chunk->column->UpdateHeight(x, z);
+	}
+
+	return result;
 }
 
 Chunk *World::GetChunk(const WorldPosition &chunkOffset) const noexcept
 {
-	const auto it = allchunks.find(chunkOffset); // Find chunk with given offset key
-	return it != allchunks.end() ? it->second : nullptr; // Return chunk if it was found
+	// Chunks are stored in their columns (nullptr if it does not exist)
+	if (chunkOffset.y < PosType{} || chunkOffset.y >= static_cast<PosType>(ChunkValues::heightCount)) return nullptr;
+	ChunkColumn *column = GetColumn({ chunkOffset.x, chunkOffset.z });
+	return column ? &column->chunks[chunkOffset.y] : nullptr;
 }
 
-PosType World::HighestBlockPosition(PosType x, PosType z) const noexcept
+ChunkColumn *World::GetColumn(const WorldXZPosition &columnOffset) const noexcept
 {
-	const PosType offsetX = ChunkValues::WorldToOffset(x), offsetZ = ChunkValues::WorldToOffset(z); // Get chunk offsets containing XZ position
-	glm::ivec3 chunkPos = { ChunkValues::WorldToLocal(x), 0, ChunkValues::WorldToLocal(z) }; // Get the local chunk position from the world position
+	// Check the grid of columns around the player first, otherwise find column with given offset key (nullptr if it does not exist)
+	ChunkColumn *column;
+	if (useChunkGrid && m_chunkGrid.Find(columnOffset, column)) return column;
+	return allcolumns.Get({ columnOffset.x, PosType{}, columnOffset.y });
+}
 
-	for (int y = ChunkValues::heightCount - 1; y >= 0; --y) {
-		Chunk *chunk = GetChunk({ offsetX, y, offsetZ });
-		if (!chunk || !chunk->chunkBlocks) continue; // Check if it is a valid chunk with blocks
-		
-		// Search the local XZ coordinate inside found chunk from top to bottom
-		const PosType worldY = y * ChunkValues::size;
-		for (chunkPos.y = ChunkValues::sizeLess; chunkPos.y >= 0; --chunkPos.y) {
-			if (chunk->chunkBlocks->at(chunkPos) != ObjectID::Air) return worldY + static_cast<PosType>(chunkPos.y);
-		}
-	}
+PosType World::HighestBlockPosition(PosType x, PosType z) const noexcept
+{
+	// Get the column containing the XZ position and use its heightmap
+	const ChunkColumn *column = GetColumn({ ChunkValues::WorldToOffset(x), ChunkValues::WorldToOffset(z) });
+	const std::uint16_t height = column ? column->heightmap[ChunkValues::WorldToLocal(x)][ChunkValues::WorldToLocal(z)] : std::uint16_t{};
 
-	// Fallback to bottom position
-	return PosType{};
+	// Fallback to bottom position if there are no blocks
+	return height ? static_cast<PosType>(height) - static_cast<PosType>(1) : PosType{};
 }
 
 PosType World::PlayerChunkDistance(const WorldPosition &chunkOffset) const noexcept
@@ -246,6 +479,20 @@ bool World::InRenderDistance(const WorldPosition &chunkOffset) const noexcept
 	return PlayerChunkDistance(chunkOffset) <= static_cast<PosType>(chunkRenderDistance);
 }
 
+PosType World::GetUnloadDistance() const noexcept
+{
+	// Chunks further than this are removed - chunks loaded in advance are kept, as well as a margin 
+	// behind the player so moving back and forth across a chunk border does not constantly regenerate them
+	return static_cast<PosType>(chunkRenderDistance + glm::max(prefetchDistance, unloadMargin));
+}
+
+double World::GetPrefetchHitRate() const noexcept
+{
+	// Percentage of chunks that were already loaded when they entered the render distance
+	const std::uintmax_t total = prefetchHits + prefetchMisses;
+	return total ? (static_cast<double>(prefetchHits) / static_cast<double>(total)) * 100.0 : 0.0;
+}
+
 void World::UpdateRenderDistance(int newRenderDistance) noexcept
 {
 	// Render distance determines how many chunks in a 'star' pattern will be generated
@@ -257,9 +504,11 @@ void World::UpdateRenderDistance(int newRenderDistance) noexcept
 	chunkRenderDistance = static_cast<std::int32_t>(newRenderDistance);
 	
 	// Maximum amount of chunk faces, calculated as ( (2 * n * n) + (2 * n) + 1 ) * h, 
-	// where n is the render distance and h is the number of chunk *faces* in a full chunk -> HEIGHT_COUNT * 6
+	// where n is the unload distance (meshed chunks can be kept past the render distance) 
+	// and h is the number of chunk *faces* in a full chunk -> HEIGHT_COUNT * 6
 	const int surroundingOffsetsAmount = GetNumChunks(false);
-	const std::size_t maxChunkFaces = surroundingOffsetsAmount * ChunkValues::heightCount * 6u;
+	const int unloadDistance = static_cast<int>(GetUnloadDistance());
+	const std::size_t maxChunkFaces = static_cast<std::size_t>((2 * unloadDistance * unloadDistance) + (2 * unloadDistance) + 1) * ChunkValues::heightCount * 6u;
 
 	// Delete any existing arrays
 	if (surroundingOffsets) delete[] surroundingOffsets;
@@ -283,6 +532,11 @@ void World::UpdateRenderDistance(int newRenderDistance) noexcept
 	int crd = static_cast<int>(chunkRenderDistance), sInd = 0;
 	for (int x = -crd; x <= crd; ++x) for (int z = -crd; z <= crd; ++z) if (glm::abs(x) + glm::abs(z) <= crd) surroundingOffsets[sInd++] = { x, z };
 
+	// Resize column grid to fit all loaded columns and add existing ones (any past the new unload distance use the map until removed)
+	m_chunkGrid.Resize(static_cast<PosType>(unloadDistance));
+	m_chunkGrid.SetCenter(m_lastUpdateOffset);
+	for (const auto &it : allcolumns) m_chunkGrid.Insert(it.second);
+
 	// Ensure correct buffers are updated
 	glBindVertexArray(m_worldVAO);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_worldSSBO);
@@ -327,101 +581,529 @@ void World::ApplyQueue(Chunk *chunk, const BlockQueueVector &blockQueue, bool ca
 	// Ignore empty vectors
 	if (!blockQueue.size()) return;
 
-	// Convert air chunk to normal per-block storage if needed
-	chunk->AllocateChunkBlocks();
+	// Convert air chunk to normal per-block storage (or copy shared blocks) if needed
+	ChunkValues::BlockArray *chunkBlocks = chunk->WritableBlocks();
 
 	// Apply queue whilst checking if certain blocks are replaceable depending on strength
 	// (only if the change is considered 'natural', such as trees)
+	// Natural changes are skipped in saved columns as they were already applied before saving
+	const int columnY = static_cast<int>(chunk->offset->y) * ChunkValues::size;
 	for (const Chunk::BlockQueue &qBlock : blockQueue) {
-		ObjectID &currentBlock = chunk->chunkBlocks->atref(qBlock.pos);
-		if (!qBlock.natural) {
+		ObjectID &currentBlock = chunkBlocks->atref(qBlock.pos);
+		if (qBlock.natural) {
+			if (chunk->column->saved) continue;
 			const WorldBlockData &currentBlockData = ChunkValues::GetBlockData(currentBlock);
 			const WorldBlockData &replaceBlockData = ChunkValues::GetBlockData(qBlock.blockID);
 			if (currentBlockData.strength > replaceBlockData.strength) continue;
 		}
+		else chunk->modified = true;
 		currentBlock = qBlock.blockID;
+		chunk->column->BlockChanged(qBlock.pos.x, columnY + qBlock.pos.y, qBlock.pos.z, qBlock.blockID == ObjectID::Air);
 	}
 
-	// Remove block queue for this chunk
-	m_blockQueue.erase(*chunk->offset);
-
-	// Calculate chunk terrain if requested
-	if (calculate) chunk->CalculateTerrainData(allchunks);
+	// Calculate chunk terrain with the other changed chunks if requested
+	if (calculate) MarkChunkDirty(chunk);
 }
 
-bool World::ApplyQueue(const BlockQueueVector &blockQueue, const WorldPosition &offset, bool calculate) noexcept
+bool World::ApplyQueue(Chunk *chunk, bool calculate) noexcept
 {
-	Chunk *chunk = GetChunk(offset); // Get chunk from given offset
-	if (!chunk) return false; // Check if it exists
-	ApplyQueue(chunk, blockQueue, calculate); // Change chunk blocks using given queue vector
+	const auto foundQueue = m_blockQueue.find(*chunk->offset); // Find queue vector from chunk offset
+	if (foundQueue == m_blockQueue.end()) return false; // Check if it exists
+	ApplyQueue(chunk, foundQueue->second, calculate); // Change chunk blocks using queue vector
+	m_blockQueue.erase(foundQueue); // Remove block queue for this chunk
 	return true;
 }
 
-bool World::ApplyQueue(Chunk *chunk, bool calculate) noexcept
+std::size_t World::QueuedBlocksCount() const noexcept
 {
-	const auto &foundQueue = m_blockQueue.find(*chunk->offset); // Find queue vector from chunk offset
-	if (foundQueue == m_blockQueue.end()) return false; // Check if it exists
-	ApplyQueue(chunk, foundQueue->second, calculate); // Change chunk blocks using queue vector
+	std::size_t count{};
+	for (const auto &it : m_blockQueue) count += it.second.size();
+	return count;
+}
+
+bool World::MarkChunkDirty(Chunk *chunk) noexcept
+{
+	// The chunk state prevents the same chunk being added multiple times
+	if (chunk->gameState == Chunk::ChunkState::UpdateRequest) return false;
+	chunk->gameState = Chunk::ChunkState::UpdateRequest;
+	m_dirtyChunks.emplace_back(*chunk->offset);
 	return true;
 }
 
-void World::ApplyUpdateRequest() noexcept
+void World::UpdateIO() noexcept
 {
-	bool updated = false;
+	// Add any columns that finished loading (or regions that finished checking) and evicted columns that came into view
+	const bool restore = m_restoreEvicted;
+	m_restoreEvicted = false;
+	if ((regions.ProcessCompletions() || restore) && !game.noGeneration) OffsetUpdate();
+
+	// Block changes from this frame are logged together, with all changed columns saved every so often to keep the log small
+	regions.FlushEdits();
+	const double time = glfwGetTime();
+	Chunk::useTime = time;
+	if (regions.LogSize() && (regions.LogSize() > RegionStorage::maxLogSize || time - m_lastCheckpoint >= checkpointInterval)) SaveCheckpoint();
+
+	if (time - m_lastBudgetCheck >= 1.0) {
+		m_lastBudgetCheck = time;
+		EnforceMemoryBudget();
+		CompressColdChunks(time);
+	}
+}
 
-	// Calculate any marked chunks
-	for (const auto &it : allchunks) {
-		if (it.second->gameState != Chunk::ChunkState::UpdateRequest) continue;
-		it.second->CalculateTerrainData(allchunks);
-		updated = true;
+void World::CompressColdChunks(double time) noexcept
+{
+	// Blocks of chunks that have not been used or in view for a while are compressed until they are next used
+	if (coldSeconds <= 0.0) return;
+	const double dblSize = static_cast<double>(ChunkValues::size);
+	const double chunkSphereRadius = Math::pythagoras(Math::pythagoras(dblSize, dblSize), dblSize) * 0.5;
+	const glm::dvec3 centerOffset = glm::dvec3(dblSize * 0.5);
+
+	int compressed = 0;
+	for (const auto &it : allcolumns) {
+		const bool columnInView = ColumnInView({ it.first.x, it.first.z });
+		for (Chunk &chunk : it.second->chunks) {
+			if (!chunk.chunkBlocks) continue; // Air or already compressed
+			const glm::dvec3 corner = *chunk.offset * static_cast<PosType>(ChunkValues::size);
+			if (!chunk.lastUsed || (columnInView && player.frustum.SphereInFrustum(corner + centerOffset, chunkSphereRadius))) { chunk.lastUsed = time; continue; }
+			if (time - chunk.lastUsed < coldSeconds || compressed >= maxColdCompressions) continue;
+			if (chunk.Compress()) ++compressed;
+			else chunk.lastUsed = time; // Tried again later (e.g. no longer shared)
+		}
 	}
+}
+
+void World::EnforceMemoryBudget() noexcept
+{
+	// Memory used by loaded columns, shared block arrays (counted once) and evicted columns
+	std::size_t total = (Chunk::blockPool.GetStats().arrays * sizeof(ChunkValues::BlockArray)) + evictedBytes;
+	std::vector<std::pair<std::uint32_t, ChunkColumn*>> candidates;
+	const PosType core = static_cast<PosType>(coreRadius);
+	for (const auto &it : allcolumns) {
+		ChunkColumn *column = it.second;
+		total += column->ResidentSize();
+		if (PlayerChunkDistance(it.first) > core && column->lastVisible != m_visibleCount) candidates.emplace_back(column->lastVisible, column);
+	}
+	residentBytes = total;
+	if (!memoryBudget || total <= memoryBudget) return;
+
+	// Columns that have been out of view for the longest are evicted first
+	std::sort(candidates.begin(), candidates.end(), [](const std::pair<std::uint32_t, ChunkColumn*> &a, const std::pair<std::uint32_t, ChunkColumn*> &b) { return a.first < b.first; });
+	std::size_t evictedCount{};
+	for (const auto &candidate : candidates) {
+		if (total <= memoryBudget) break;
+		const std::size_t columnSize = candidate.second->ResidentSize(), evictedBefore = evictedBytes;
+		EvictColumn(candidate.second);
+		total = total - columnSize + (evictedBytes - evictedBefore);
+		++evictedCount;
+	}
+
+	// Evicted columns can use up to a quarter of the budget, with the oldest ones after that being saved to 
+	// region files if they were changed (loaded from there when needed) or otherwise removed (generated again)
+	if (evictedBytes > memoryBudget / static_cast<std::size_t>(4u)) {
+		std::vector<std::pair<std::uint32_t, WorldPosition>> evictedOffsets;
+		for (const auto &it : m_evictedColumns) evictedOffsets.emplace_back(it.second.lastVisible, it.first);
+		std::sort(evictedOffsets.begin(), evictedOffsets.end(), [](const std::pair<std::uint32_t, WorldPosition> &a, const std::pair<std::uint32_t, WorldPosition> &b) { return a.first < b.first; });
+		for (const auto &evicted : evictedOffsets) {
+			if (evictedBytes <= memoryBudget / static_cast<std::size_t>(4u)) break;
+			const std::size_t evictedBefore = evictedBytes;
+			DropEvicted(m_evictedColumns.find(evicted.second));
+			total -= evictedBefore - evictedBytes;
+		}
+		regions.Flush();
+	}
+
+	residentBytes = total;
+	evictedColumnsCount += static_cast<std::uintmax_t>(evictedCount);
+	if (evictedCount) QueueBufferUpdate(); // Remove faces of evicted columns
+}
+
+void World::EvictColumn(ChunkColumn *column) noexcept
+{
+	// Blocks are kept compressed, with any changes saved once the column is no longer kept
+	const WorldPosition offset = column->Offset();
+	EvictedColumn &evicted = m_evictedColumns[offset];
+	evicted.blocks.clear();
+	RegionStorage::EncodeColumn(*column, evicted.blocks);
+	evicted.blocks.shrink_to_fit();
+	evicted.lastVisible = column->lastVisible;
+	evicted.saved = column->saved;
+	evicted.modifiedChunks = std::uint8_t{};
+	for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) if (column->chunks[chunkY].modified) evicted.modifiedChunks |= static_cast<std::uint8_t>(1u << chunkY);
+	evictedBytes += evicted.blocks.capacity();
+
+	RemoveColumn(column, false);
+	allcolumns.erase(allcolumns.find(offset));
+}
+
+World::EvictedMap::iterator World::DropEvicted(EvictedMap::const_iterator evicted) noexcept
+{
+	// Changed columns are saved (written in the next flush)
+	evictedBytes -= evicted->second.blocks.capacity();
+	if (evicted->second.modifiedChunks) regions.SaveColumn({ evicted->first.x, evicted->first.z }, std::vector<std::uint8_t>(evicted->second.blocks));
+	return m_evictedColumns.erase(evicted);
+}
 
-	// Update buffers to show changes
-	if (updated) UpdateWorldBuffers();
+bool World::ColumnInView(const WorldXZPosition &offset) const noexcept
+{
+	// Whole height of the column as the highest chunk is not known for evicted columns
+	const double size = static_cast<double>(ChunkValues::size);
+	const glm::dvec3 corner = WorldPosition(offset.x, PosType{}, offset.y) * static_cast<PosType>(ChunkValues::size);
+	return player.frustum.BoxInFrustum(corner, corner + glm::dvec3(size, static_cast<double>(ChunkValues::maxHeight), size));
 }
 
-void World::AddSurrounding(Chunk::WorldMapDef &chunksMap, NearbyChunkData *nearbyData, const WorldPosition &offset, bool inclY) const noexcept
+void World::SaveCheckpoint() noexcept
 {
-	const int numSurrounding = GetNearbyChunks(offset, nearbyData, inclY); // Get number of chunks surrounding given offset
-	// Add chunks surrounding given offset to given map
-	for (int j = 0; j < numSurrounding; ++j) {
-		Chunk *nearbyChunk = nearbyData[j].nearbyChunk;
-		chunksMap[*nearbyChunk->offset] = nearbyChunk;
+	// Save all columns changed since they were last saved so the edit log only needs changes to unloaded chunks
+	for (const auto &it : allcolumns) {
+		ChunkColumn *column = it.second;
+		if (!column->IsModified()) continue;
+		regions.SaveColumn(*column);
+		for (Chunk &chunk : column->chunks) chunk.modified = false;
+	}
+	for (auto &it : m_evictedColumns) {
+		if (!it.second.modifiedChunks) continue;
+		regions.SaveColumn({ it.first.x, it.first.z }, std::vector<std::uint8_t>(it.second.blocks));
+		it.second.modifiedChunks = std::uint8_t{};
+	}
+	regions.Flush();
+
+	std::vector<EditLog::Edit> keptEdits;
+	for (const auto &it : m_blockQueue) {
+		const WorldPosition corner = it.first * static_cast<PosType>(ChunkValues::size);
+		for (const Chunk::BlockQueue &queued : it.second) {
+			if (queued.natural) continue;
+			const EditLog::Edit edit = { corner + WorldPosition(queued.pos), ObjectID::NumUnique, queued.blockID };
+			keptEdits.emplace_back(edit);
+		}
 	}
+	regions.CompactLog(std::move(keptEdits));
+	m_lastCheckpoint = glfwGetTime();
+}
+
+void World::LoadSeeds() noexcept
+{
+	// The seeds of the last world are kept so it is continued (with its saved changes) when the game starts again.
+	// A new world with random seeds is made if there is no valid seeds file.
+	// TODO (possible): noise splines for more varied terrain generation
+	const std::string seedsPath = "Worlds/world.seeds";
+	std::int64_t seeds[WorldNoise::MAX];
+	std::ifstream seedsFile(seedsPath, std::ios::binary);
+	if (seedsFile.read(reinterpret_cast<char*>(seeds), sizeof(seeds)) && seedsFile.peek() == std::ifstream::traits_type::eof()) {
+		game.noiseGenerators = WorldNoise(nullptr, seeds);
+		return;
+	}
+
+	game.noiseGenerators = WorldNoise(nullptr);
+	const WorldPerlin *perlins[] = { &game.noiseGenerators.elevation, &game.noiseGenerators.flatness, &game.noiseGenerators.depth,
+		&game.noiseGenerators.temperature, &game.noiseGenerators.humidity };
+	for (int i = 0; i < WorldNoise::MAX; ++i) seeds[i] = perlins[i]->seed;
+
+	// Without the file, the world still works but a new one is made next time
+	try {
+		if (!FileManager::DirectoryExists("Worlds")) FileManager::CreatePath("Worlds");
+	} catch (const FileManager::FileError &error) {
+		TextFormat::warn(error.what(), "World seeds error");
+	}
+	std::ofstream output(seedsPath, std::ios::binary | std::ios::trunc);
+	if (!output.write(reinterpret_cast<const char*>(seeds), sizeof(seeds)) || !output.flush()) {
+		TextFormat::warn(fmt::format("World seeds could not be saved to '{}'", seedsPath), "World seeds error");
+	}
+}
+
+void World::TakeSnapshot(WorldSnapshot &snapshot) noexcept
+{
+	// Chunk blocks are added to the pool (if they are not already) so the snapshot can share them
+	snapshot.Clear();
+	snapshot.columns.reserve(allcolumns.size());
+	for (const auto &it : allcolumns) {
+		ChunkColumn *column = it.second;
+		WorldSnapshot::Column saved = { { it.first.x, it.first.z }, {}, std::uint8_t{}, column->saved };
+		for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) {
+			Chunk &chunk = column->chunks[chunkY];
+			if (chunk.modified) saved.modifiedChunks |= static_cast<std::uint8_t>(1u << chunkY);
+			if (chunk.IsAir()) continue;
+
+			// Compressed chunks are kept as they are (a decompressed copy is used instead)
+			if (chunk.compressedBlocks) {
+				ChunkValues::BlockArray *blocks = new ChunkValues::BlockArray;
+				chunk.CopyBlocks(*blocks);
+				saved.blocks[chunkY] = Chunk::blockPool.Share(blocks);
+				continue;
+			}
+			if (!chunk.sharedBlocks) {
+				chunk.chunkBlocks = Chunk::blockPool.Share(chunk.chunkBlocks);
+				chunk.sharedBlocks = true;
+			}
+			saved.blocks[chunkY] = Chunk::blockPool.Reference(chunk.chunkBlocks);
+		}
+		snapshot.columns.emplace_back(saved);
+	}
+
+	for (const auto &it : m_evictedColumns) {
+		const WorldSnapshot::EvictedColumn evicted = { { it.first.x, it.first.z }, it.second.blocks, it.second.modifiedChunks, it.second.saved };
+		snapshot.evicted.emplace_back(evicted);
+	}
+	for (const auto &it : m_blockQueue) {
+		const WorldSnapshot::QueuedBlocks queue = { it.first, it.second };
+		snapshot.queues.emplace_back(queue);
+	}
+}
+
+void World::RestoreSnapshot(const WorldSnapshot &snapshot) noexcept
+{
+	// Finish any loading columns first so they are not added after being replaced
+	regions.WaitIdle();
+	regions.ProcessCompletions();
+
+	for (auto it = allcolumns.cbegin(); it != allcolumns.cend();) { RemoveColumn(it->second, false); allcolumns.erase(it++); }
+	for (const auto &it : m_loadedColumns) delete it.second.column;
+	m_loadedColumns.clear();
+	m_evictedColumns.clear();
+	evictedBytes = std::size_t{};
+	m_blockQueue.clear();
+	m_deferredChunks.clear();
+	m_dirtyChunks.clear();
+	journal.Clear(); // Positions of undone blocks may not match the restored world
+	m_chunkGrid.Clear();
+
+	// Columns are added in the offset update as if they were loaded from region files. Columns that may have been saved
+	// after the snapshot (including ones whose region file has not been read yet) are treated as changed so the snapshot
+	// blocks replace them in the next checkpoint (other saved columns are not known to the snapshot, so they are loaded
+	// with their saved changes).
+	for (const WorldSnapshot::Column &saved : snapshot.columns) {
+		ChunkColumn *column = new ChunkColumn(saved.offset);
+		const bool savedSince = regions.GetColumnState(saved.offset) != RegionStorage::ColumnState::NotSaved;
+		for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) {
+			Chunk &chunk = column->chunks[chunkY];
+			chunk.modified = savedSince || ((saved.modifiedChunks >> chunkY) & 1u);
+			if (!saved.blocks[chunkY]) continue;
+			chunk.chunkBlocks = Chunk::blockPool.Reference(saved.blocks[chunkY]);
+			chunk.sharedBlocks = true;
+		}
+		for (int x = 0; x < ChunkValues::size; ++x) for (int z = 0; z < ChunkValues::size; ++z) column->UpdateHeight(x, z);
+		column->saved = saved.saved;
+		m_loadedColumns[{ saved.offset.x, PosType{}, saved.offset.y }] = { column, {} };
+	}
+
+	for (const WorldSnapshot::EvictedColumn &saved : snapshot.evicted) {
+		const bool savedSince = regions.GetColumnState(saved.offset) != RegionStorage::ColumnState::NotSaved;
+		const EvictedColumn evicted = { saved.blocks, m_visibleCount, savedSince ? static_cast<std::uint8_t>((1u << ChunkValues::heightCount) - 1u) : saved.modifiedChunks, saved.saved };
+		evictedBytes += evicted.blocks.capacity();
+		m_evictedColumns[{ saved.offset.x, PosType{}, saved.offset.y }] = evicted;
+	}
+	for (const WorldSnapshot::QueuedBlocks &queue : snapshot.queues) m_blockQueue[queue.offset] = queue.blocks;
+
+	player.position = snapshot.position;
+	player.offset = ChunkValues::WorldToOffset(snapshot.position);
+	OffsetUpdate();
+
+	// Changes made since the snapshot are removed from the edit log
+	SaveCheckpoint();
+}
+
+void World::UpdateDirtyChunks() noexcept
+{
+	if (m_dirtyChunks.empty()) return;
+
+	// Offsets are stored instead of chunks as they could have been unloaded since being added
+	Chunk **chunkCalcArray = new Chunk*[m_dirtyChunks.size()];
+	int chunkCalcCount = 0;
+	for (const WorldPosition &offset : m_dirtyChunks) {
+		Chunk *chunk = GetChunk(offset);
+		if (!chunk || chunk->gameState != Chunk::ChunkState::UpdateRequest) continue; // Unloaded or already added
+		chunk->gameState = Chunk::ChunkState::Normal;
+		if (chunk->meshed) chunkCalcArray[chunkCalcCount++] = chunk; // Others will include the changes when they are first calculated
+	}
+	m_dirtyChunks.clear();
+
+	// Calculate all changed chunks in parallel and update buffers to show changes (edited blocks are
+	// unlikely to match a cached mesh, so the cache is only used for loaded and generated chunks)
+	CalculateChunks(chunkCalcArray, chunkCalcCount, false);
+	delete[] chunkCalcArray;
+	if (chunkCalcCount) QueueBufferUpdate();
+}
+
+bool World::IsMeshReady(const Chunk *chunk) const noexcept
+{
+	// A chunk can be calculated once all of its horizontal neighbours exist, or if it is on the edge of the
+	// render distance where the outer neighbours will not be generated (their border faces are hidden anyway)
+	const PosType distance = PlayerChunkDistance(*chunk->offset), renderDistance = static_cast<PosType>(chunkRenderDistance);
+	return distance <= renderDistance && (chunk->HasAllNearby() || distance == renderDistance);
+}
+
+void World::LinkNearbyChunks(Chunk *chunk, Chunk::WorldMapDef &affectedChunks) noexcept
+{
+	// Point the given chunk and its neighbours to each other
+	for (int i = 0; i < 6; ++i) {
+		Chunk *nearbyChunk = GetChunk(*chunk->offset + game.constants.worldDirections[i]);
+		if (!nearbyChunk) continue;
+
+		// Opposite direction is the next/previous index (right <-> left, up <-> down, front <-> back)
+		const WorldDirection direction = static_cast<WorldDirection>(i), opposite = static_cast<WorldDirection>(i ^ 1);
+		chunk->nearbyChunks[direction] = nearbyChunk;
+		nearbyChunk->nearbyChunks[opposite] = chunk;
+
+		// Existing chunks only need calculating again if their faces on the shared horizontal border change 
+		// (vertical neighbours are always created together in the same full chunk)
+		if (direction == WldDir_Up || direction == WldDir_Down) continue;
+		if (nearbyChunk->meshed && nearbyChunk->BorderNeedsUpdate(opposite, chunk)) affectedChunks[*nearbyChunk->offset] = nearbyChunk;
+	}
+}
+
+void World::UnlinkNearbyChunks(const Chunk *chunk) noexcept
+{
+	// Remove the given chunk from its neighbours (no calculation needed as the faces on the removed
+	// border are now on the edge of the loaded area and cannot be seen)
+	for (int i = 0; i < 6; ++i) {
+		Chunk *nearbyChunk = chunk->nearbyChunks[i];
+		if (nearbyChunk) nearbyChunk->nearbyChunks[i ^ 1] = nullptr;
+	}
+}
+
+int World::GetPrefetchOffsets(WorldXZPosition *prefetchOffsets) const noexcept
+{
+	// Determine the direction the player is heading in (or looking at if they are not moving)
+	glm::dvec2 direction = { player.velocity.x, player.velocity.z };
+	double directionLength = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (directionLength < 0.01) {
+		const double yawRad = glm::radians(player.yaw);
+		direction = { std::cos(yawRad), std::sin(yawRad) };
+		directionLength = 1.0;
+	}
+	direction /= directionLength;
+
+	// Chunks on each 'ring' of the diamond pattern past the render distance that are roughly
+	// in the direction of travel (within ~60 degrees) are loaded ahead of time
+	const double minDirectionDot = 0.5;
+	int count = 0;
+
+	for (int ring = chunkRenderDistance + 1, lastRing = chunkRenderDistance + prefetchDistance; ring <= lastRing; ++ring) {
+		for (int x = -ring; x <= ring; ++x) {
+			const int remaining = ring - glm::abs(x);
+			for (int side = 0; side < (remaining ? 2 : 1); ++side) {
+				const int z = side ? -remaining : remaining;
+				const double ringLength = std::sqrt(static_cast<double>((x * x) + (z * z)));
+				const double dot = ((static_cast<double>(x) * direction.x) + (static_cast<double>(z) * direction.y)) / ringLength;
+				if (dot >= minDirectionDot) prefetchOffsets[count++] = { player.offset.x + x, player.offset.z + z };
+			}
+		}
+	}
+
+	return count;
 }
 
 void World::OffsetUpdate() noexcept
 {
 	Chunk::WorldMapDef affectedChunks; // Store unique affected chunks requiring calculation
-	NearbyChunkData nearbyData[4]; // Store direction and pointer to nearby chunks
+	const PosType unloadDistance = GetUnloadDistance();
 
-	for (auto it = allchunks.cbegin(); it != allchunks.cend();) {
-		WorldPosition offset = it->first;
-		if (InRenderDistance(offset)) { ++it; continue; }; // Check if it is further than the render distance
-		delete it->second;
-		allchunks.erase(it++);
+	for (auto it = allcolumns.cbegin(); it != allcolumns.cend();) {
+		if (PlayerChunkDistance(it->first) <= unloadDistance) { ++it; continue; }; // Check if it is further than the unload distance
+		RemoveColumn(it->second);
+		allcolumns.erase(it++);
 	}
+	// Loaded and evicted columns that are no longer needed
+	for (auto it = m_loadedColumns.begin(); it != m_loadedColumns.end();) {
+		if (PlayerChunkDistance(it->first) <= unloadDistance) { ++it; continue; }
+		delete it->second.column;
+		it = m_loadedColumns.erase(it);
+	}
+	for (auto it = m_evictedColumns.begin(); it != m_evictedColumns.end();) {
+		if (PlayerChunkDistance(it->first) <= unloadDistance) ++it;
+		else it = DropEvicted(it);
+	}
+	regions.Flush(); // Write all saved columns together
+
+	m_chunkGrid.SetCenter({ player.offset.x, player.offset.z }); // All remaining columns are within the unload distance
 	
 	const int numFullChunks = GetNumChunks(false);
 	int newOffsetsCount = 0;
 
+	// Maximum number of chunks in the prefetch rings (each ring of the diamond pattern has 4 * distance chunks)
+	const int crd = static_cast<int>(chunkRenderDistance), lastRing = crd + static_cast<int>(prefetchDistance);
+	const int maxPrefetchChunks = (2 * ((lastRing * (lastRing + 1)) - (crd * (crd + 1))));
+
 	// Player X and Z offset - use to determine new chunk offsets
 	const WorldXZPosition playerOffset = { player.offset.x, player.offset.z };
-	WorldXZPosition *newOffsets = new WorldXZPosition[numFullChunks]; // XZ offsets of chunks that need creating
+	WorldXZPosition *newOffsets = new WorldXZPosition[numFullChunks + maxPrefetchChunks]; // XZ offsets of chunks that need creating
+
+	// Only count prefetch results for chunks entering the render distance due to player movement
+	const bool countPrefetch = m_hasUpdated && playerOffset != m_lastUpdateOffset;
+	const PosType renderDistance = static_cast<PosType>(chunkRenderDistance);
 	
 	// Create a full chunk around the player if one doesn't exist already
 	for (int offsetInd = 0; offsetInd < numFullChunks; ++offsetInd) {
 		const WorldXZPosition newXZOffset = playerOffset + surroundingOffsets[offsetInd]; // Get XZ offset of possible chunk
-		if (GetChunk({ newXZOffset.x, PosType{}, newXZOffset.y })) continue; // Check if it already exists
-		newOffsets[newOffsetsCount++] = newXZOffset; // Chunks need to be created at this offset
+		const bool exists = GetColumn(newXZOffset) != nullptr; // Check if it already exists
+
+		// Determine if the chunk was previously outside of the render distance and if it was already loaded
+		if (countPrefetch && glm::abs(newXZOffset.x - m_lastUpdateOffset.x) + glm::abs(newXZOffset.y - m_lastUpdateOffset.y) > renderDistance) {
+			if (exists) ++prefetchHits; else ++prefetchMisses;
+		}
+
+		if (!exists) newOffsets[newOffsetsCount++] = newXZOffset; // Chunks need to be created at this offset
+	}
+
+	// Chunks ahead of the player are loaded with a lower priority after the required ones
+	// (they are not calculated until they are inside of the render distance)
+	if (prefetchDistance > 0) {
+		WorldXZPosition *prefetchOffsets = new WorldXZPosition[maxPrefetchChunks];
+		const int prefetchCount = GetPrefetchOffsets(prefetchOffsets);
+		for (int i = 0; i < prefetchCount; ++i) {
+			const WorldXZPosition &prefetchOffset = prefetchOffsets[i];
+			if (!GetColumn(prefetchOffset)) newOffsets[newOffsetsCount++] = prefetchOffset;
+		}
+		delete[] prefetchOffsets;
+	}
+
+	m_lastUpdateOffset = playerOffset;
+	m_hasUpdated = true;
+
+	// Saved columns are loaded on the I/O thread first and added in a later update once they have loaded
+	ChunkColumn **columnArray = new ChunkColumn*[newOffsetsCount](); // Array of newly created columns
+	int createCount = 0;
+	for (int i = 0; i < newOffsetsCount; ++i) {
+		const WorldXZPosition columnOffset = newOffsets[i];
+		const WorldPosition columnKey = { columnOffset.x, PosType{}, columnOffset.y };
+		const auto loaded = m_loadedColumns.find(columnKey);
+		const auto evicted = m_evictedColumns.find(columnKey);
+
+		if (evicted != m_evictedColumns.end()) {
+			// Evicted columns are only restored once they are in view again (or close to the player)
+			if (PlayerChunkDistance(columnKey) > static_cast<PosType>(coreRadius) && !ColumnInView(columnOffset)) continue;
+			ChunkColumn *column = RegionStorage::CreateColumn(columnOffset, evicted->second.blocks.data(), evicted->second.blocks.size());
+			if (column) {
+				column->saved = evicted->second.saved;
+				for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) column->chunks[chunkY].modified = (evicted->second.modifiedChunks >> chunkY) & 1u;
+			}
+			columnArray[createCount] = column; // Generated below if invalid
+			evictedBytes -= evicted->second.blocks.capacity();
+			m_evictedColumns.erase(evicted);
+			++restoredColumnsCount;
+		}
+		else if (loaded != m_loadedColumns.end()) {
+			columnArray[createCount] = loaded->second.column; // Generated below if not saved or invalid
+			QueueSavedBlocks(columnOffset, loaded->second.pending);
+			m_loadedColumns.erase(loaded);
+		}
+		else {
+			const RegionStorage::ColumnState state = regions.GetColumnState(columnOffset);
+			if (state == RegionStorage::ColumnState::Saved) regions.LoadColumn(columnOffset, [this](RegionStorage::LoadResult &result) {
+				LoadedColumn &loadedColumn = m_loadedColumns[{ result.offset.x, PosType{}, result.offset.y }];
+				loadedColumn.column = result.column;
+				loadedColumn.pending = std::move(result.pending);
+				result.column = nullptr; // Taken
+			});
+			if (state != RegionStorage::ColumnState::NotSaved) continue; // Still loading (or checking the region)
+		}
+
+		newOffsets[createCount++] = columnOffset;
 	}
+	newOffsetsCount = createCount;
 
 	// Number of full chunks per thread
 	const int numFullChunksEach = newOffsetsCount / game.numThreads;
 	int numFullChunksLeft = newOffsetsCount - (numFullChunksEach * game.numThreads); // Size may not be a multiple of threads count
-	const int chunkArrayLen = newOffsetsCount * ChunkValues::heightCount;
-
-	Chunk **chunkArray = new Chunk*[chunkArrayLen]; // Array of newly created chunks
 
 	for (int thread = 0, threadIndex = 0; thread < game.numThreads; ++thread) {
 		const int start = threadIndex;
@@ -430,71 +1112,137 @@ void World::OffsetUpdate() noexcept
 		// Create the full chunks in parallel
 		game.genThreads[thread] = std::thread([&](int mapInd, int offsetStart, int offsetsEnd) {
 			Chunk::BlockQueueMap &threadMap = threadMaps[mapInd];
-			int chunksStart = offsetStart * ChunkValues::heightCount;
 			WorldPerlin::NoiseResult* noiseResults = new WorldPerlin::NoiseResult[ChunkValues::sizeSquared];
 			
 			for (int i = offsetStart; i < offsetsEnd; ++i) {
-				const WorldXZPosition &fullChunkOffset = newOffsets[i]; // Get the full chunk offset
+				if (columnArray[i]) continue; // Already loaded from a region file
+				const WorldXZPosition &columnOffset = newOffsets[i]; // Get the column offset
 				// Calculate the noise values for terrain generation
-				SetPerlinValues(noiseResults, fullChunkOffset * static_cast<PosType>(ChunkValues::size));
+				SetPerlinValues(noiseResults, columnOffset * static_cast<PosType>(ChunkValues::size));
 				
-				// Create each chunk of the full chunk
-				WorldPosition offset = { fullChunkOffset.x, PosType{}, fullChunkOffset.y };
-				do {
-					Chunk *newChunk = new Chunk();
-					chunkArray[chunksStart++] = newChunk;
-					newChunk->ConstructChunk(noiseResults, threadMap, offset);
-				} while (++offset.y < static_cast<PosType>(ChunkValues::heightCount));
+				// Create each chunk of the column
+				ChunkColumn *column = new ChunkColumn(columnOffset);
+				column->Generate(noiseResults, threadMap);
+				columnArray[i] = column;
 			}
 
 			delete[] noiseResults; // Ensure noise array is deleted
 		}, thread, start, threadIndex);
 	}
 
-	// Wait for all threads to finish and set the offset pointers of each chunk
+	// Wait for all threads to finish
 	for (int threadInd = 0; threadInd < game.numThreads; ++threadInd) {
 		game.genThreads[threadInd].join(); // Wait for the thread to finish
 		
-		// Merge the thread queue map with the main one
+		// Move the thread queues into the main map (the whole vector is taken if the chunk has no queue yet)
 		Chunk::BlockQueueMap &threadMap = threadMaps[threadInd];
-		for (const auto &it : threadMap) {
+		for (auto &it : threadMap) {
 			Chunk::BlockQueueVector &main = m_blockQueue[it.first];
-			const Chunk::BlockQueueVector threadVec = it.second;
-			main.insert(main.end(), threadVec.begin(), threadVec.end());
+			if (main.empty()) main.swap(it.second);
+			else main.insert(main.end(), std::make_move_iterator(it.second.begin()), std::make_move_iterator(it.second.end()));
 		}
+		threadMap.clear(); // Emptied for the next update (keeps its slots)
 	}
 
-	for (int i = 0; i < chunkArrayLen; ++i) {
-		// Offsets are in a specific order so they can be calculated instead of stored
-		const WorldXZPosition &fullOffset = newOffsets[i / ChunkValues::heightCount];
-		const WorldPosition offset = { fullOffset.x, static_cast<PosType>(i % ChunkValues::heightCount), fullOffset.y };
+	for (int i = 0; i < newOffsetsCount; ++i) {
+		ChunkColumn *column = columnArray[i];
+		column->lastVisible = m_visibleCount; // Not evicted straight away
+		allcolumns.insert({ column->Offset(), column });
+		m_chunkGrid.Insert(column);
+	}
 
-		Chunk *chunk = chunkArray[i];
-		// Add surrounding chunks to 'affected' map
-		affectedChunks[offset] = chunk; // Add current chunk
-		chunk->offset = &allchunks.insert({ offset, chunk }).first->first; // Set offset pointer
-		AddSurrounding(affectedChunks, nearbyData, offset, false); // Add surrounding chunks to affected map
+	// Link new chunks with their neighbours once they have all been added (so new chunks can also find each other).
+	// Each new chunk is only calculated once all of its neighbours exist instead of being calculated again later.
+	for (int i = 0; i < newOffsetsCount; ++i) {
+		for (Chunk &chunk : columnArray[i]->chunks) {
+			LinkNearbyChunks(&chunk, affectedChunks); // Add existing neighbours with changed borders to affected map
+			m_deferredChunks[*chunk.offset] = &chunk; // Calculated below once ready
+		}
 	}
+	generatedChunksCount += static_cast<std::uintmax_t>(newOffsetsCount * ChunkValues::heightCount);
 
-	// Offsets and chunk array no longer needed - use affected map
-	delete[] chunkArray;
+	// Offsets and column array no longer needed - use affected map
+	delete[] columnArray;
 	delete[] newOffsets;
 
-	// Apply any block queue present
-	std::vector<Chunk::BlockQueuePair> vecVals;
-	std::transform(m_blockQueue.begin(), m_blockQueue.end(), std::back_inserter(vecVals), [&](Chunk::BlockQueuePair &p) { return p; });
-	for (const auto &pair : vecVals) ApplyQueue(pair.second, pair.first, false);
+	// Apply any block queue present (applied queues are removed straight away, the map allows erasing whilst iterating)
+	for (auto it = m_blockQueue.begin(); it != m_blockQueue.end();) {
+		Chunk *chunk = GetChunk(it->first);
+		if (!chunk) { ++it; continue; }
+		ApplyQueue(chunk, it->second, false);
+		if (chunk->meshed) affectedChunks[it->first] = chunk; // Already calculated chunks need to show the queued blocks
+		it = m_blockQueue.erase(it);
+	}
+
+	// Add any waiting chunks that are now ready to be calculated
+	for (auto it = m_deferredChunks.cbegin(); it != m_deferredChunks.cend();) {
+		Chunk *chunk = it->second;
+		if (!chunk->meshed && !IsMeshReady(chunk)) { ++it; continue; } // Keep waiting for neighbours
+		if (!chunk->meshed) affectedChunks[it->first] = chunk; // (Could have been calculated elsewhere already)
+		m_deferredChunks.erase(it++);
+	}
 
 	// Calculate chunks in the 'affected' map in parallel
-	const int affectedSize = static_cast<int>(affectedChunks.size()), numChunksEach = affectedSize / static_cast<std::size_t>(game.numThreads);
-	int numChunksLast = affectedSize - static_cast<std::size_t>(numChunksEach * game.numThreads);
+	Chunk **chunkCalcArray = new Chunk*[affectedChunks.size()];
+	int chunkCalcCount = 0;
+	for (const auto &it : affectedChunks) chunkCalcArray[chunkCalcCount++] = it.second;
+	CalculateChunks(chunkCalcArray, chunkCalcCount, true);
+	delete[] chunkCalcArray; // Clear chunk array
+
+	// Remove block queues in far chunks (would stay forever even if the player moved far away) - 
+	// changes that were not natural (e.g. filling unloaded chunks) are saved until the column is loaded again
+	for (auto it = m_blockQueue.cbegin(); it != m_blockQueue.cend();) { 
+		if (PlayerChunkDistance(it->first) < unloadDistance + static_cast<PosType>(2)) { ++it; continue; }
+		regions.SavePending(it->first, it->second);
+		it = m_blockQueue.erase(it);
+	}
+	regions.Flush();
+	
+	QueueBufferUpdate(); // Update world buffers to use new chunk data
+}
+
+void World::QueueSavedBlocks(const WorldXZPosition &columnOffset, const std::vector<RegionStorage::SavedBlock> &blocks) noexcept
+{
+	// Changes made whilst the column was unloaded, which go before any queued since (e.g. recovered from the edit log)
+	Chunk::BlockQueueVector chunkBlocks[ChunkValues::heightCount];
+	for (const RegionStorage::SavedBlock &block : blocks) {
+		const glm::ivec3 localPos = { block.x, block.y & ChunkValues::sizeLess, block.z };
+		chunkBlocks[block.y >> ChunkValues::sizeBits].emplace_back(Chunk::BlockQueue(localPos, block.blockID, false));
+	}
+
+	for (int chunkY = 0; chunkY < ChunkValues::heightCount; ++chunkY) {
+		if (chunkBlocks[chunkY].empty()) continue;
+		Chunk::BlockQueueVector &queue = m_blockQueue[{ columnOffset.x, static_cast<PosType>(chunkY), columnOffset.y }];
+		queue.insert(queue.begin(), chunkBlocks[chunkY].begin(), chunkBlocks[chunkY].end());
+	}
+}
+
+void World::RemoveColumn(ChunkColumn *column, bool save) noexcept
+{
+	// Column still needs to be erased from the column map after this
+	for (const Chunk &chunk : column->chunks) {
+		UnlinkNearbyChunks(&chunk);
+		m_deferredChunks.erase(*chunk.offset);
+	}
+	if (save && column->IsModified()) regions.SaveColumn(*column); // Written in the next flush
+	m_chunkGrid.Remove(column);
+	delete column;
+}
+
+void World::CalculateChunks(Chunk **chunks, int count, bool useCache) noexcept
+{
+	if (!count) return;
 
-	// Put map values into array for non-linear access
-	int chunkCalcArrayIndex = 0;
-	Chunk **chunkCalcArray = new Chunk*[affectedSize];
-	for (const auto &it : affectedChunks) chunkCalcArray[chunkCalcArrayIndex++] = it.second;
+	// Blocks of the chunks and their neighbours are read on other threads so they are decompressed here first
+	for (int i = 0; i < count; ++i) {
+		chunks[i]->Blocks();
+		for (Chunk *nearbyChunk : chunks[i]->nearbyChunks) if (nearbyChunk) nearbyChunk->Blocks();
+	}
 
 	// Split chunk calculation amongst multiple threads
+	const int numChunksEach = count / game.numThreads;
+	int numChunksLast = count - (numChunksEach * game.numThreads);
+
 	for (int thread = 0, threadStartIndex = 0; thread < game.numThreads; ++thread) {
 		const int arrayStart = threadStartIndex; // Starting index
 		threadStartIndex += numChunksEach + (numChunksLast-- > 0 ? 1 : 0); // Spread the excess chunks across threads
@@ -502,22 +1250,35 @@ void World::OffsetUpdate() noexcept
 		// Calculate in parallel
 		game.genThreads[thread] = std::thread([&](int start, int end) {
 			std::uint32_t *quadData = new std::uint32_t[ChunkValues::blocksAmount];
-			for (int i = start; i < end; ++i) chunkCalcArray[i]->CalculateTerrainData(allchunks, quadData);
+			for (int i = start; i < end; ++i) {
+				// Chunks with the same blocks (and neighbouring blocks) as a cached mesh use its faces instead
+				Chunk *chunk = chunks[i];
+				if (!useCache || !chunk->chunkBlocks || !meshCache.memoryLimit) { chunk->CalculateTerrainData(quadData); continue; }
+				const MeshCache::Key key = MeshCache::ChunkKey(*chunk);
+				if (meshCache.Find(key, *chunk)) continue;
+				chunk->CalculateTerrainData(quadData);
+				meshCache.Add(key, *chunk);
+			}
 			delete[] quadData;
 		}, arrayStart, threadStartIndex);
 	}
 
-	// Wait for all threads to finish and delete them
+	// Wait for all threads to finish
 	for (int t = 0; t < game.numThreads; ++t) game.genThreads[t].join();
+	meshedChunksCount += static_cast<std::uintmax_t>(count);
+}
 
-	delete[] chunkCalcArray; // Clear chunk array
+void World::QueueBufferUpdate() noexcept
+{
+	// Any number of changes in a frame only need one buffer update (which also sorts the buffers)
+	static const char updateKey{};
+	game.tasks.Post([this]() { UpdateWorldBuffers(); }, GameGlobal::TaskQueue::TP_High, &updateKey);
+}
 
-	// Remove block queues in far chunks (could keep, but would stay forever even if the player moved far away)
-	for (auto it = m_blockQueue.cbegin(); it != m_blockQueue.cend();) { 
-		if (PlayerChunkDistance(it->first) >= static_cast<PosType>(static_cast<int>(chunkRenderDistance) + 2)) m_blockQueue.erase(it++); else ++it;
-	}
-	
-	UpdateWorldBuffers(); // Update world buffers to use new chunk data
+void World::QueueBufferSort() noexcept
+{
+	static const char sortKey{};
+	game.tasks.Post([this]() { SortWorldBuffers(); }, GameGlobal::TaskQueue::TP_High, &sortKey);
 }
 
 void World::UpdateWorldBuffers() noexcept
@@ -528,13 +1289,15 @@ void World::UpdateWorldBuffers() noexcept
 
 	// Loop through all of the chunks and each of their 6 face data to determine how much memory is needed
 	// overall and accumulate all the valid pointer data into the array, as well as preparing to delete any far away chunks
-	for (const auto &it : allchunks) {
-		// Loop through all of the chunk's face data
-		for (Chunk::FaceAxisData &faceData : it.second->chunkFaceData) {
-			const std::uint32_t totalFaces = faceData.TotalFaces<std::uint32_t>();
-			if (!totalFaces) continue; // This chunk has no faces, so no need to do anything
-			faceDataPointers[faceDataPointersCount++] = &faceData;
-			squaresCount += totalFaces;
+	for (const auto &it : allcolumns) {
+		for (Chunk &chunk : it.second->chunks) {
+			// Loop through all of the chunk's face data
+			for (Chunk::FaceAxisData &faceData : chunk.chunkFaceData) {
+				const std::uint32_t totalFaces = faceData.TotalFaces<std::uint32_t>();
+				if (!totalFaces) continue; // This chunk has no faces, so no need to do anything
+				faceDataPointers[faceDataPointersCount++] = &faceData;
+				squaresCount += totalFaces;
+			}
 		}
 	}
 
@@ -586,6 +1349,7 @@ void World::UpdateWorldBuffers() noexcept
 void World::SortWorldBuffers() noexcept
 {
 	game.perfs.renderSort.Start();
+	++m_visibleCount; // Columns in view are given the new count
 
 	// Offset value data
 	ShaderChunkFace offsetData;
@@ -605,65 +1369,78 @@ void World::SortWorldBuffers() noexcept
 
 	// After storing the normal face data for every chunk, loop through the individual chunk faces
 	// that have translucent faces, giving the offset and chunk data for each
-	for (const auto &it : allchunks) {
-		Chunk *chunk = it.second;
-		if (!chunk->chunkBlocks) continue; // Ignore 'air' (empty) chunks
-
-		const WorldPosition &offset = it.first;
-
-		// Use frustum culling to determine if the chunk is on-screen
-		const glm::dvec3 corner = offset * static_cast<PosType>(ChunkValues::size); // Get chunk corner
-		if (!player.frustum.SphereInFrustum(corner + centerOffset, chunkSphereRadius)) continue;
-		++renderChunksCount;
-		
-		// Set offset data for shader
-		offsetData.worldPositionX = corner.x;
-		offsetData.worldPositionZ = corner.z;
-
-		for (std::uint32_t faceIndex{}; faceIndex < static_cast<std::uint32_t>(6); ++faceIndex) {
-			const Chunk::FaceAxisData &faceData = chunk->chunkFaceData[faceIndex];
-			if (!faceData.TotalFaces<std::uint32_t>()) continue; // No faces present
-
-			// Store world Y position and face index in a single variable (last 3 bits = index, rest are Y position)
-			offsetData.faceIndexAndY = static_cast<std::uint32_t>(corner.y) + (faceIndex << static_cast<std::uint32_t>(29));
+	for (const auto &it : allcolumns) {
+		const ChunkColumn *column = it.second;
+		const int highestChunk = column->HighestChunk();
+		if (highestChunk < 0) continue; // Ignore columns with only air chunks
+
+		// Reject whole columns that are off-screen before testing each chunk (box only goes up to the highest chunk with blocks)
+		const glm::dvec3 columnCorner = it.first * static_cast<PosType>(ChunkValues::size);
+		const glm::dvec3 columnTop = columnCorner + glm::dvec3(dblSize, dblSize * static_cast<double>(highestChunk + 1), dblSize);
+		if (!player.frustum.BoxInFrustum(columnCorner, columnTop)) continue;
+		it.second->lastVisible = m_visibleCount;
+
+		for (int chunkY = 0; chunkY <= highestChunk; ++chunkY) {
+			Chunk *chunk = &it.second->chunks[chunkY];
+			if (chunk->IsAir()) continue; // Ignore 'air' (empty) chunks
+
+			const WorldPosition &offset = *chunk->offset;
+
+			// Use frustum culling to determine if the chunk is on-screen
+			const glm::dvec3 corner = offset * static_cast<PosType>(ChunkValues::size); // Get chunk corner
+			if (!player.frustum.SphereInFrustum(corner + centerOffset, chunkSphereRadius)) continue;
+			++renderChunksCount;
 			
-			// Add to vector if transparency is present
-			if (faceData.translucentFaceCount) {
-				ChunkTranslucentData &translucentData = translucentChunks[translucentChunksCount++];
-				translucentData.chunk = chunk;
-				translucentData.offsetData = offsetData;
-			}
+			// Set offset data for shader
+			offsetData.worldPositionX = corner.x;
+			offsetData.worldPositionZ = corner.z;
 
-			// Check if it would even be possible to see this (opaque) face of the chunk
-			// e.g. you can't see forward faces when looking north at a chunk
-			
-			switch (faceIndex) {
-				case WldDir_Right:
-					if (player.offset.x < offset.x) continue;
-					break;
-				case WldDir_Left:
-					if (player.offset.x > offset.x) continue;
-					break;
-				case WldDir_Up:
-					if (player.offset.y < offset.y) continue;
-					break;
-				case WldDir_Down:
-					if (player.offset.y > offset.y) continue;
-					break;
-				case WldDir_Front:
-					if (player.offset.z < offset.z) continue;
-					break;
-				case WldDir_Back:
-					if (player.offset.z > offset.z) continue;
-					break;
-				default:
-					break;
-			}
+			for (std::uint32_t faceIndex{}; faceIndex < static_cast<std::uint32_t>(6); ++faceIndex) {
+				const Chunk::FaceAxisData &faceData = chunk->chunkFaceData[faceIndex];
+				if (!faceData.TotalFaces<std::uint32_t>()) continue; // No faces present
+				if (faceData.instancesData) continue; // New face data has not been buffered yet (buffer update is queued)
 
-			// Set indirect and offset data at the same indexes in both buffers
-			worldIndirectData[m_indirectCalls] = { 4u, faceData.faceCount, 0u, faceData.dataIndex };
-			worldOffsetData[m_indirectCalls++] = offsetData; // Advance to next indirect call
-			renderSquaresCount += faceData.TotalFaces<std::uint32_t>();
+				// Store world Y position and face index in a single variable (last 3 bits = index, rest are Y position)
+				offsetData.faceIndexAndY = static_cast<std::uint32_t>(corner.y) + (faceIndex << static_cast<std::uint32_t>(29));
+				
+				// Add to vector if transparency is present
+				if (faceData.translucentFaceCount) {
+					ChunkTranslucentData &translucentData = translucentChunks[translucentChunksCount++];
+					translucentData.chunk = chunk;
+					translucentData.offsetData = offsetData;
+				}
+
+				// Check if it would even be possible to see this (opaque) face of the chunk
+				// e.g. you can't see forward faces when looking north at a chunk
+				
+				switch (faceIndex) {
+					case WldDir_Right:
+						if (player.offset.x < offset.x) continue;
+						break;
+					case WldDir_Left:
+						if (player.offset.x > offset.x) continue;
+						break;
+					case WldDir_Up:
+						if (player.offset.y < offset.y) continue;
+						break;
+					case WldDir_Down:
+						if (player.offset.y > offset.y) continue;
+						break;
+					case WldDir_Front:
+						if (player.offset.z < offset.z) continue;
+						break;
+					case WldDir_Back:
+						if (player.offset.z > offset.z) continue;
+						break;
+					default:
+						break;
+				}
+
+				// Set indirect and offset data at the same indexes in both buffers
+				worldIndirectData[m_indirectCalls] = { 4u, faceData.faceCount, 0u, faceData.dataIndex };
+				worldOffsetData[m_indirectCalls++] = offsetData; // Advance to next indirect call
+				renderSquaresCount += faceData.TotalFaces<std::uint32_t>();
+			}
 		}
 	}
 
@@ -686,23 +1463,28 @@ void World::SortWorldBuffers() noexcept
 	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, GLintptr{}, static_cast<GLsizeiptr>(sizeof(IndirectDrawCommand) * static_cast<std::size_t>(m_indirectCalls)), worldIndirectData);
 	glBufferSubData(GL_SHADER_STORAGE_BUFFER, GLintptr{}, static_cast<GLsizeiptr>(sizeof(ShaderChunkFace) * static_cast<std::size_t>(m_indirectCalls)), worldOffsetData);
 
+	// Restore any evicted columns that are now in view (in the next IO update)
+	for (const auto &it : m_evictedColumns) {
+		if (m_restoreEvicted) break;
+		m_restoreEvicted = InRenderDistance(it.first) && ColumnInView({ it.first.x, it.first.z });
+	}
+
 	game.perfs.renderSort.End();
 }
 
-int World::GetNearbyChunks(const WorldPosition &offset, NearbyChunkData *nearbyData, bool includeY) const noexcept
+int World::GetNearbyChunks(const Chunk *chunk, NearbyChunkData *nearbyData, bool includeY) const noexcept
 {
-	int found = 0, dirIndex = -1;
+	int found = 0;
 
-	for (const WorldPosition &dir : game.constants.worldDirections) {
-		++dirIndex; // Advance to next 'direction'
-		if (!includeY && (dir.y != 0)) continue; // Ignore 'Y' offsets when choosing not to include them
+	for (int dirIndex = 0; dirIndex < 6; ++dirIndex) {
+		if (!includeY && (dirIndex == WldDir_Up || dirIndex == WldDir_Down)) continue; // Ignore 'Y' offsets when choosing not to include them
 
-		// Find chunk and check if it exists
-		const auto &foundChunk = allchunks.find(offset + dir);
-		if (foundChunk == allchunks.end()) continue;
+		// Check if the neighbouring chunk exists
+		Chunk *nearbyChunk = chunk->nearbyChunks[dirIndex];
+		if (!nearbyChunk) continue;
 
 		// Add to nearby data
-		nearbyData[found++] = { foundChunk->second, static_cast<WorldDirection>(dirIndex) };
+		nearbyData[found++] = { nearbyChunk, static_cast<WorldDirection>(dirIndex) };
 	}
 
 	return found; // Only loop thru valid parts of nearby data array
@@ -719,8 +1501,16 @@ int World::GetNumChunks(bool includeHeight) const noexcept
 
 World::~World() noexcept
 {
-	// Delete all chunks
-	for (const auto &it : allchunks) delete it.second;
+	// Save changed columns and delete all columns (and their chunks)
+	for (const auto &it : allcolumns) {
+		if (it.second->IsModified()) regions.SaveColumn(*it.second);
+		delete it.second;
+	}
+	for (auto it = m_evictedColumns.begin(); it != m_evictedColumns.end();) it = DropEvicted(it);
+	for (const auto &it : m_blockQueue) regions.SavePending(it.first, it.second);
+	for (const auto &it : m_loadedColumns) delete it.second.column;
+	regions.Flush(); // Written before the I/O thread stops
+	regions.CompactLog({}); // Everything is saved
 
 	// Delete created buffer objects
 	const GLuint deleteBuffers[] = { 
@@ -3,16 +3,42 @@
 #define _SOURCE_WORLD_WLD_HEADER_
 
 #include "Player/PlayerDef.hpp"
+#include "ChunkGrid.hpp"
+#include "RegionStorage.hpp"
+#include "MeshCache.hpp"
+#include "EditJournal.hpp"
+#include "WorldSnapshot.hpp"
 
 class World
 {
 public:
-	Chunk::WorldMapDef allchunks;
+	Chunk::ColumnMapDef allcolumns;
 	TextRenderer textRenderer;
 
 	WorldPlayer &player;
 	std::uint32_t squaresCount, renderSquaresCount, renderChunksCount;
+	std::uintmax_t generatedChunksCount{}, meshedChunksCount{};
 	std::int32_t chunkRenderDistance = static_cast<std::int32_t>(4);
+	std::int32_t prefetchDistance = static_cast<std::int32_t>(2); // Extra chunks loaded ahead of the player
+	std::int32_t unloadMargin = static_cast<std::int32_t>(2); // Extra chunks kept loaded behind the player
+	std::uintmax_t prefetchHits{}, prefetchMisses{};
+	bool useChunkGrid = true; // Look up columns in the grid around the player before the column map
+	RegionStorage regions; // Changed columns are saved when unloaded and loaded instead of being generated again
+	std::string directory; // Saved files of this world (named after its seed, which is kept between games)
+	double checkpointInterval = 60.0; // Seconds between saving all changed columns (edit log is compacted)
+	bool saveEdits = true; // Whether SetBlock(s) changes are logged and mark chunks to be saved (off for temporary changes)
+	MeshCache meshCache; // Faces of previously calculated chunks with the same blocks
+	EditJournal journal; // Block changes that can be undone (each edit function call is one action)
+
+	// Columns out of view for the longest (outside of the core radius) are evicted once chunks use more memory than the budget
+	std::size_t memoryBudget{}; // Bytes (0 for no limit)
+	std::int32_t coreRadius = static_cast<std::int32_t>(8); // Columns this close to the player are never evicted
+	std::size_t residentBytes{}, evictedBytes{}; // Memory used by chunks and evicted columns (at the last budget check)
+	std::uintmax_t evictedColumnsCount{}, restoredColumnsCount{};
+	std::size_t EvictedColumns() const noexcept { return m_evictedColumns.size(); }
+
+	double coldSeconds = 30.0; // Chunks unused and out of view for this long have their blocks compressed (0 to disable)
+	static constexpr int maxColdCompressions = 256; // Spreads compressing many chunks over multiple checks
 
 	World(WorldPlayer &player) noexcept;
 	void DrawWorld() const noexcept;
@@ -20,30 +46,66 @@ public:
 	void DebugChunkBorders(bool drawing) noexcept;
 	void DebugReset() noexcept;
 
+	// Loaded and evicted columns and queued blocks (player state is handled by the caller). Restoring replaces everything
+	// currently loaded (discarding changes since the snapshot) with the player placed at the snapshot position first.
+	// Columns outside the snapshot keep any changes saved to region files since, as only the latest version is stored.
+	void TakeSnapshot(WorldSnapshot &snapshot) noexcept;
+	void RestoreSnapshot(const WorldSnapshot &snapshot) noexcept;
+
 	Chunk *WorldPositionToChunk(const WorldPosition &pos) const noexcept;
 	ObjectID GetBlock(const WorldPosition &pos) const noexcept;
-	void SetBlock(const WorldPosition &pos, ObjectID block, bool updateChunk) noexcept;
+	void GetBlocks(const WorldPosition *positions, ObjectID *blocks, std::size_t count) const noexcept;
+	// Changed chunks are calculated together once per frame (in UpdateDirtyChunks)
+	void SetBlock(const WorldPosition &pos, ObjectID block) noexcept;
+	void SetBlocks(const WorldPosition *positions, const ObjectID *blocks, std::size_t count) noexcept;
+	bool MarkChunkDirty(Chunk *chunk) noexcept;
+	void UpdateDirtyChunks() noexcept;
+	void UpdateIO() noexcept;
 
 	Chunk *GetChunk(const WorldPosition &offset) const noexcept;
+	ChunkColumn *GetColumn(const WorldXZPosition &offset) const noexcept;
 	PosType HighestBlockPosition(PosType x, PosType z) const noexcept;
 
 	PosType PlayerChunkDistance(const WorldPosition &chunkOffset) const noexcept;
 	bool InRenderDistance(const WorldPosition &chunkOffset) const noexcept;
+	PosType GetUnloadDistance() const noexcept;
+	double GetPrefetchHitRate() const noexcept;
+	std::size_t QueuedBlocksCount() const noexcept;
+	std::size_t QueueChunksCount() const noexcept { return m_blockQueue.size(); }
 
 	void UpdateRenderDistance(int newRenderDistance) noexcept;
 
-	std::uintmax_t FillBlocks(WorldPosition from, WorldPosition to, ObjectID objectID) noexcept;
+	// Change blocks in a shape - spheres and cylinders (vertical) fit in the box between the two corners (inclusive)
+	struct BlockEdit {
+		enum Shape : std::uint8_t { ES_Box, ES_Sphere, ES_Cylinder };
+		BlockEdit(const WorldPosition &from, const WorldPosition &to, ObjectID block) noexcept : from(from), to(to), block(block) {}
+		WorldPosition from, to;
+		ObjectID block;
+		Shape shape = ES_Box;
+		bool replaceOnly = false; // Only change blocks that are the same as 'replaceBlock'
+		ObjectID replaceBlock = ObjectID::Air;
+	};
+	struct BlockEditResult {
+		std::uintmax_t changed, queued, chunks; // Blocks changed in loaded chunks, blocks queued for unloaded chunks and chunks to calculate
+		bool tooLarge; // Nothing is changed if too many blocks would be queued
+	};
+	static constexpr std::uintmax_t maxQueuedEdit = 32768u;
+
+	BlockEditResult EditBlocks(BlockEdit edit) noexcept;
+	BlockEditResult UndoEdit(bool redo = false) noexcept; // Changes each chunk at once like an edit (nothing changed if there is no action)
 
 	void OffsetUpdate() noexcept;
 	void UpdateWorldBuffers() noexcept;
 	void SortWorldBuffers() noexcept;
+	void QueueBufferUpdate() noexcept;
+	void QueueBufferSort() noexcept;
 
 	struct NearbyChunkData {
 		Chunk *nearbyChunk;
 		WorldDirection direction;
 	};
 
-	int GetNearbyChunks(const WorldPosition &offset, NearbyChunkData *nearbyData, bool includeY) const noexcept;
+	int GetNearbyChunks(const Chunk *chunk, NearbyChunkData *nearbyData, bool includeY) const noexcept;
 
 	int GetIndirectCalls() const noexcept;
 	int GetNumChunks(bool includeHeight = true) const noexcept;
@@ -61,15 +123,57 @@ private:
 	bool canMap = false;
 
 	typedef std::vector<Chunk::BlockQueue> BlockQueueVector;
-	std::unordered_map<WorldPosition, BlockQueueVector, Math::WPHash> m_blockQueue;
+	Chunk::BlockQueueMap m_blockQueue;
 
 	void ApplyQueue(Chunk *chunk, const BlockQueueVector &blockQueue, bool calc) noexcept;
-	bool ApplyQueue(const BlockQueueVector &blockQueue, const WorldPosition &offset, bool calc) noexcept;
 	bool ApplyQueue(Chunk *chunk, bool calc) noexcept;
 
-	void AddSurrounding(Chunk::WorldMapDef &chunksMap, NearbyChunkData *nearbyData, const WorldPosition &offset, bool inclY) const noexcept;
-
-	void ApplyUpdateRequest() noexcept;
+	// Columns loaded by the I/O thread (nullptr if they need generating), added in the next offset update
+	struct LoadedColumn {
+		ChunkColumn *column;
+		std::vector<RegionStorage::SavedBlock> pending;
+	};
+	FlatPositionMap<LoadedColumn> m_loadedColumns;
+	void QueueSavedBlocks(const WorldXZPosition &columnOffset, const std::vector<RegionStorage::SavedBlock> &blocks) noexcept;
+
+	Chunk::WorldMapDef m_deferredChunks;
+	std::vector<WorldPosition> m_dirtyChunks; // Offsets of changed chunks to calculate in the next frame
+	ChunkGrid m_chunkGrid;
+	WorldXZPosition m_lastUpdateOffset{};
+	bool m_hasUpdated = false;
+
+	int GetPrefetchOffsets(WorldXZPosition *prefetchOffsets) const noexcept;
+
+	bool IsMeshReady(const Chunk *chunk) const noexcept;
+	void LinkNearbyChunks(Chunk *chunk, Chunk::WorldMapDef &affectedChunks) noexcept;
+	void UnlinkNearbyChunks(const Chunk *chunk) noexcept;
+
+	void CalculateChunks(Chunk **chunks, int count, bool useCache) noexcept;
+	void RemoveColumn(ChunkColumn *column, bool save = true) noexcept;
+	void SaveCheckpoint() noexcept;
+	void LoadSeeds() noexcept;
+
+	// Compressed blocks of a column evicted to stay within the memory budget
+	struct EvictedColumn {
+		std::vector<std::uint8_t> blocks;
+		std::uint32_t lastVisible;
+		std::uint8_t modifiedChunks; // Bit for each chunk changed since it was last saved
+		bool saved;
+	};
+	static_assert(ChunkValues::heightCount <= 8, "Changed chunks of evicted columns are stored as 8 bits.");
+	typedef FlatPositionMap<EvictedColumn> EvictedMap;
+	EvictedMap m_evictedColumns;
+	std::uint32_t m_visibleCount{}; // Increased every world buffer sort
+	double m_lastBudgetCheck = 0.0;
+	bool m_restoreEvicted = false;
+
+	void EnforceMemoryBudget() noexcept;
+	void EvictColumn(ChunkColumn *column) noexcept;
+	EvictedMap::iterator DropEvicted(EvictedMap::const_iterator evicted) noexcept;
+	bool ColumnInView(const WorldXZPosition &offset) const noexcept;
+	void CompressColdChunks(double time) noexcept;
+	double m_lastCheckpoint = 0.0;
+	void SetChunkBlock(Chunk *chunk, const WorldPosition &offset, const glm::ivec3 &localPos, ObjectID block) noexcept;
 
 	struct ShaderChunkFace {
 		double worldPositionX;
@@ -0,0 +1,216 @@
+#include "WorldSnapshot.hpp"
+#include "RegionStorage.hpp"
+
+namespace
+{
+	const char snapshotMagic[4] = { 'B', 'C', 'W', 'S' };
+	const std::uint32_t snapshotVersion = 1u;
+
+	template<typename T> void Put(std::vector<std::uint8_t> &data, T value)
+	{
+		const std::size_t start = data.size();
+		data.resize(start + sizeof(T));
+		std::memcpy(data.data() + start, &value, sizeof(T));
+	}
+
+	// Reads values in order, returning zeroes once past the end of the data
+	struct SnapshotReader {
+		const std::uint8_t *data;
+		std::size_t size, position;
+		bool valid;
+
+		template<typename T> T Get() noexcept {
+			T value{};
+			if (size - position < sizeof(T)) { valid = false; position = size; return value; }
+			std::memcpy(&value, data + position, sizeof(T));
+			position += sizeof(T);
+			return value;
+		}
+	};
+}
+
+void WorldSnapshot::Clear() noexcept
+{
+	for (const Column &column : columns) {
+		for (ChunkValues::BlockArray *blocks : column.blocks) if (blocks) Chunk::blockPool.Release(blocks);
+	}
+	columns.clear();
+	evicted.clear();
+	queues.clear();
+}
+
+bool WorldSnapshot::Write(const std::string &path) const noexcept
+{
+	std::vector<std::uint8_t> data(snapshotMagic, snapshotMagic + sizeof(snapshotMagic));
+	Put(data, snapshotVersion);
+	Put(data, seed);
+
+	// Player and time
+	for (int i = 0; i < 3; ++i) Put(data, position[i]);
+	for (int i = 0; i < 3; ++i) Put(data, velocity[i]);
+	Put(data, yaw);
+	Put(data, pitch);
+	for (const InventorySlot &slot : inventory) { Put(data, static_cast<std::uint8_t>(slot.objectID)); Put(data, slot.count); }
+	Put(data, static_cast<std::uint8_t>(noclip));
+	Put(data, static_cast<std::uint8_t>(doGravity));
+	Put(data, daySeconds);
+	Put(data, worldDay);
+
+	// Each chunk is either air (0) or run-length encoded (1)
+	Put(data, static_cast<std::uint32_t>(columns.size()));
+	for (const Column &column : columns) {
+		Put(data, static_cast<std::int64_t>(column.offset.x));
+		Put(data, static_cast<std::int64_t>(column.offset.y));
+		Put(data, column.modifiedChunks);
+		Put(data, static_cast<std::uint8_t>(column.saved));
+		for (const ChunkValues::BlockArray *blocks : column.blocks) {
+			data.emplace_back(static_cast<std::uint8_t>(blocks != nullptr));
+			if (blocks) RegionStorage::EncodeBlocks(*blocks, data);
+		}
+	}
+
+	Put(data, static_cast<std::uint32_t>(evicted.size()));
+	for (const EvictedColumn &column : evicted) {
+		Put(data, static_cast<std::int64_t>(column.offset.x));
+		Put(data, static_cast<std::int64_t>(column.offset.y));
+		Put(data, column.modifiedChunks);
+		Put(data, static_cast<std::uint8_t>(column.saved));
+		Put(data, static_cast<std::uint32_t>(column.blocks.size()));
+		data.insert(data.end(), column.blocks.begin(), column.blocks.end());
+	}
+
+	Put(data, static_cast<std::uint32_t>(queues.size()));
+	for (const QueuedBlocks &queue : queues) {
+		for (int i = 0; i < 3; ++i) Put(data, static_cast<std::int64_t>(queue.offset[i]));
+		Put(data, static_cast<std::uint32_t>(queue.blocks.size()));
+		for (const Chunk::BlockQueue &block : queue.blocks) {
+			for (int i = 0; i < 3; ++i) Put(data, block.pos[i]);
+			Put(data, static_cast<std::uint8_t>(block.blockID));
+			Put(data, static_cast<std::uint8_t>(block.natural));
+		}
+	}
+
+	// Create the directories containing the file, then write to a separate file first so the previous snapshot is kept if writing fails
+	try {
+		for (std::size_t end = path.find('/'); end != std::string::npos; end = path.find('/', end + 1u)) {
+			const std::string directory = path.substr(std::size_t{}, end);
+			if (!directory.empty() && !FileManager::DirectoryExists(directory)) FileManager::CreatePath(directory);
+		}
+	} catch (const FileManager::FileError &error) {
+		TextFormat::warn(error.what(), "Snapshot write error");
+		return false;
+	}
+
+	const std::string tempPath = path + ".tmp";
+	std::FILE *file = std::fopen(tempPath.c_str(), "wb");
+	if (!file) return false;
+	const bool written = std::fwrite(data.data(), std::size_t{ 1u }, data.size(), file) == data.size();
+	if (std::fclose(file) || !written) return false;
+
+	std::remove(path.c_str()); // Renaming does not replace existing files on Windows
+	return !std::rename(tempPath.c_str(), path.c_str());
+}
+
+bool WorldSnapshot::Read(const std::string &path) noexcept
+{
+	MappedFile file;
+	if (!file.Open(path, true)) return false;
+
+	// Read into a separate snapshot so this one is kept if the file is invalid
+	WorldSnapshot read;
+	if (!read.Parse(file.Data(), file.Size())) {
+		TextFormat::warn(fmt::format("Snapshot '{}' is invalid", path), "Snapshot read error");
+		return false;
+	}
+	Swap(read);
+	return true;
+}
+
+void WorldSnapshot::Swap(WorldSnapshot &other) noexcept
+{
+	columns.swap(other.columns);
+	evicted.swap(other.evicted);
+	queues.swap(other.queues);
+	std::swap(seed, other.seed);
+	std::swap(position, other.position);
+	std::swap(velocity, other.velocity);
+	std::swap(yaw, other.yaw);
+	std::swap(pitch, other.pitch);
+	std::swap(inventory, other.inventory);
+	std::swap(noclip, other.noclip);
+	std::swap(doGravity, other.doGravity);
+	std::swap(daySeconds, other.daySeconds);
+	std::swap(worldDay, other.worldDay);
+}
+
+bool WorldSnapshot::Parse(const std::uint8_t *data, std::size_t size) noexcept
+{
+	SnapshotReader reader = { data, size, std::size_t{}, true };
+	if (size < sizeof(snapshotMagic) || std::memcmp(data, snapshotMagic, sizeof(snapshotMagic))) reader.valid = false;
+	reader.position = sizeof(snapshotMagic);
+	if (reader.Get<std::uint32_t>() != snapshotVersion) reader.valid = false;
+	seed = reader.Get<std::int64_t>();
+
+	for (int i = 0; i < 3; ++i) position[i] = reader.Get<double>();
+	for (int i = 0; i < 3; ++i) velocity[i] = reader.Get<double>();
+	yaw = reader.Get<double>();
+	pitch = reader.Get<double>();
+	for (InventorySlot &slot : inventory) {
+		slot.objectID = static_cast<ObjectID>(reader.Get<std::uint8_t>());
+		slot.count = reader.Get<std::uint8_t>();
+		if (slot.objectID >= ObjectID::NumUnique) slot = { ObjectID::Air, std::uint8_t{} };
+	}
+	noclip = reader.Get<std::uint8_t>() != 0u;
+	doGravity = reader.Get<std::uint8_t>() != 0u;
+	daySeconds = reader.Get<double>();
+	worldDay = reader.Get<std::int64_t>();
+
+	// Decoded blocks are added to the pool so identical chunks are only stored once
+	for (std::uint32_t count = reader.Get<std::uint32_t>(); count && reader.valid; --count) {
+		Column column{};
+		column.offset.x = static_cast<PosType>(reader.Get<std::int64_t>());
+		column.offset.y = static_cast<PosType>(reader.Get<std::int64_t>());
+		column.modifiedChunks = reader.Get<std::uint8_t>();
+		column.saved = reader.Get<std::uint8_t>() != 0u;
+		for (ChunkValues::BlockArray *&blocks : column.blocks) {
+			if (!reader.Get<std::uint8_t>()) continue;
+			ChunkValues::BlockArray *decoded = new ChunkValues::BlockArray;
+			if (!RegionStorage::DecodeBlocks(reader.data, reader.size, reader.position, *decoded)) { delete decoded; reader.valid = false; break; }
+			blocks = Chunk::blockPool.Share(decoded);
+		}
+		columns.emplace_back(column); // Added even if invalid so the arrays are released
+	}
+
+	for (std::uint32_t count = reader.Get<std::uint32_t>(); count && reader.valid; --count) {
+		EvictedColumn column;
+		column.offset.x = static_cast<PosType>(reader.Get<std::int64_t>());
+		column.offset.y = static_cast<PosType>(reader.Get<std::int64_t>());
+		column.modifiedChunks = reader.Get<std::uint8_t>();
+		column.saved = reader.Get<std::uint8_t>() != 0u;
+		const std::size_t size = static_cast<std::size_t>(reader.Get<std::uint32_t>());
+		if (reader.size - reader.position < size) { reader.valid = false; break; }
+		column.blocks.assign(reader.data + reader.position, reader.data + reader.position + size);
+		reader.position += size;
+		evicted.emplace_back(std::move(column));
+	}
+
+	for (std::uint32_t count = reader.Get<std::uint32_t>(); count && reader.valid; --count) {
+		QueuedBlocks queue;
+		for (int i = 0; i < 3; ++i) queue.offset[i] = static_cast<PosType>(reader.Get<std::int64_t>());
+		for (std::uint32_t blockCount = reader.Get<std::uint32_t>(); blockCount && reader.valid; --blockCount) {
+			glm::ivec3 pos;
+			bool inChunk = true;
+			for (int i = 0; i < 3; ++i) {
+				pos[i] = static_cast<int>(reader.Get<std::int8_t>());
+				inChunk = inChunk && pos[i] >= 0 && pos[i] < ChunkValues::size;
+			}
+			const ObjectID block = static_cast<ObjectID>(reader.Get<std::uint8_t>());
+			const bool natural = reader.Get<std::uint8_t>() != 0u;
+			if (block >= ObjectID::NumUnique || !inChunk) reader.valid = false;
+			else queue.blocks.emplace_back(Chunk::BlockQueue(pos, block, natural));
+		}
+		queues.emplace_back(std::move(queue));
+	}
+
+	return reader.valid;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef _SOURCE_WORLD_WORLDSNAPSHOT_HDR_
+#define _SOURCE_WORLD_WORLDSNAPSHOT_HDR_
+
+#include "Chunk.hpp"
+
+// Loaded columns, queued blocks and player state at one point in time, so the same world can be restored for repeatable
+// testing (e.g. benchmarks) or going back after changes. Block arrays are shared with the chunks through the block pool
+// so taking a snapshot does not copy them (chunks copy them before changing any blocks). Snapshots can be written to a
+// single file, which is memory-mapped when read.
+struct WorldSnapshot
+{
+	struct Column {
+		WorldXZPosition offset;
+		ChunkValues::BlockArray *blocks[ChunkValues::heightCount]; // From the block pool (nullptr for air chunks)
+		std::uint8_t modifiedChunks; // Bit for each chunk changed since it was last saved
+		bool saved;
+	};
+	static_assert(ChunkValues::heightCount <= 8, "Changed chunks of snapshot columns are stored as 8 bits.");
+
+	// Columns evicted to stay within the memory budget (already encoded)
+	struct EvictedColumn {
+		WorldXZPosition offset;
+		std::vector<std::uint8_t> blocks;
+		std::uint8_t modifiedChunks;
+		bool saved;
+	};
+
+	struct QueuedBlocks {
+		WorldPosition offset;
+		Chunk::BlockQueueVector blocks;
+	};
+
+	struct InventorySlot {
+		ObjectID objectID;
+		std::uint8_t count;
+	};
+
+	WorldSnapshot() noexcept {}
+	WorldSnapshot(const WorldSnapshot&) = delete;
+	WorldSnapshot &operator=(const WorldSnapshot&) = delete;
+	~WorldSnapshot() { Clear(); }
+
+	void Clear() noexcept; // Stops using the shared block arrays
+	bool IsEmpty() const noexcept { return columns.empty(); }
+
+	// The whole file is built first and written at once. Nothing is changed if reading fails.
+	bool Write(const std::string &path) const noexcept;
+	bool Read(const std::string &path) noexcept;
+	void Swap(WorldSnapshot &other) noexcept;
+
+	std::vector<Column> columns;
+	std::vector<EvictedColumn> evicted;
+	std::vector<QueuedBlocks> queues;
+
+	std::int64_t seed{}; // Only restored into the world it was taken in
+	glm::dvec3 position{}, velocity{};
+	double yaw = 0.0, pitch = 0.0;
+	InventorySlot inventory[36]{};
+	bool noclip = false, doGravity = false;
+	double daySeconds = 0.0;
+	std::int64_t worldDay{};
+private:
+	bool Parse(const std::uint8_t *data, std::size_t size) noexcept; // Anything read before an error is kept until cleared
+};
+
+#endif // _SOURCE_WORLD_WORLDSNAPSHOT_HDR_